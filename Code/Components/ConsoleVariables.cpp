@@ -1,14 +1,115 @@
+#include "StdAfx.h"
 #include "ConsoleVariables.h"
+#include "Components/Player.h"
+#include "Components/PlayerArchetype.h"
+#include "Components/PlayerMemoryPool.h"
+#include "Components/PlayerSpawnPool.h"
+#include "Input/InputRecorder.h"
+#include "Profiling/AllocationTracker.h"
+#include "Profiling/FrameStats.h"
+#include "Profiling/LatencyStats.h"
+#include "Profiling/MemoryStats.h"
+#include "Profiling/NodeProfiler.h"
+#include "Profiling/TraceRecorder.h"
 #include <CrySystem/IConsole.h>
 #include <CrySystem/ConsoleRegistration.h>
 
+CConsoleVariables* CConsoleVariables::s_pThis = nullptr;
+
 void CConsoleVariables::RegisterCVars()
 {
 	ConsoleRegistrationHelper::RegisterFloat("g_WalkSpeed", 0, VF_RESTRICTEDMODE, "Player Walk Speed");
+
+	// Profiling
+	ConsoleRegistrationHelper::Register("pl_traceCapacity", &pl_traceCapacity, pl_traceCapacity, VF_NULL, "Number of events preallocated by pl_traceStart");
+	ConsoleRegistrationHelper::AddCommand("pl_traceStart", CPlayerTraceRecorder::CmdStart, VF_NULL, "Starts recording player trace events. Usage: pl_traceStart [capacity]");
+	ConsoleRegistrationHelper::AddCommand("pl_traceStop", CPlayerTraceRecorder::CmdStop, VF_NULL, "Stops recording player trace events");
+	ConsoleRegistrationHelper::AddCommand("pl_traceDump", CPlayerTraceRecorder::CmdDump, VF_NULL, "Writes recorded player trace events as Chrome trace JSON. Usage: pl_traceDump [path]");
+	ConsoleRegistrationHelper::Register("pl_statsLogInterval", &pl_statsLogInterval, pl_statsLogInterval, VF_NULL, "Seconds between periodic logs of the player work counters, 0 disables the log");
+	ConsoleRegistrationHelper::AddCommand("pl_stats", CPlayerFrameStats::CmdLog, VF_NULL, "Logs the per-frame player work counters (last, average and peak)");
+	ConsoleRegistrationHelper::AddCommand("pl_statsReset", CPlayerFrameStats::CmdReset, VF_NULL, "Resets the player work counters");
+	ConsoleRegistrationHelper::AddCommand("pl_allocLog", CPlayerAllocationTracker::CmdLog, VF_NULL, "Logs heap allocations per player call site (PLAYER_ALLOCATION_TRACKING builds)");
+	ConsoleRegistrationHelper::AddCommand("pl_allocReset", CPlayerAllocationTracker::CmdReset, VF_NULL, "Resets the per call site allocation counters");
+	ConsoleRegistrationHelper::AddCommand("pl_allocCheck", CPlayerAllocationTracker::CmdCheck, VF_NULL, "Fails if a steady-state frame allocates. Usage: pl_allocCheck [frames] [warmupFrames]");
+	ConsoleRegistrationHelper::AddCommand("pl_latency", CPlayerLatencyStats::CmdLog, VF_NULL, "Logs input-to-write latency histograms for the camera transform, rotation and velocity");
+	ConsoleRegistrationHelper::AddCommand("pl_latencyReset", CPlayerLatencyStats::CmdReset, VF_NULL, "Resets the input latency histograms");
+	ConsoleRegistrationHelper::AddCommand("pl_memory", CPlayerMemoryStats::CmdLog, VF_NULL, "Logs the memory owned by all players, in total and per player, by category");
+	ConsoleRegistrationHelper::AddCommand("pl_archetypes", CPlayerArchetypeRegistry::CmdLog, VF_NULL, "Logs the interned player archetypes and how many players share each");
+	ConsoleRegistrationHelper::Register("pl_nodeProfile", &pl_nodeProfile, pl_nodeProfile, VF_NULL, "1 collects activation counts and timings of the Player Component flow nodes, see pl_nodeStats");
+	ConsoleRegistrationHelper::AddCommand("pl_nodeStats", CPlayerNodeProfiler::CmdLog, VF_NULL, "Logs Player Component flow node activations per node type and for the slowest instances. Usage: pl_nodeStats [instanceCount]");
+	ConsoleRegistrationHelper::AddCommand("pl_nodeStatsReset", CPlayerNodeProfiler::CmdReset, VF_NULL, "Resets the flow node activation counters");
+
+	// Input
+	ConsoleRegistrationHelper::Register("pl_inputQueue", &pl_inputQueue, pl_inputQueue, VF_NULL, "1 queues input callbacks and applies them at the start of the player update, 0 applies them inside the callback");
+	ConsoleRegistrationHelper::Register("pl_rawMouseLook", &pl_rawMouseLook, pl_rawMouseLook, VF_NULL, "1 takes the local player's mouse look straight from the input events instead of the yaw/pitch action callbacks");
+	ConsoleRegistrationHelper::Register("pl_stickLookRate", &pl_stickLookRate, pl_stickLookRate, VF_NULL, "Look speed of a fully deflected stick (yawstick/pitchstick), in mouse counts per second scaled by the Player Rotation Speed");
+	pl_bindingProfile = ConsoleRegistrationHelper::RegisterString("pl_bindingProfile", "Libs/Config/PlayerBindings.xml", VF_NULL, "XML binding profile applied to players, compiled to %USER%/player_bindings.pbnd on first load. Changing it rebinds every player", CPlayerComponent::OnBindingProfileChanged);
+	ConsoleRegistrationHelper::AddCommand("pl_rebindStress", CPlayerComponent::CmdRebindStress, VF_NULL, "Rebinds moveforward repeatedly on the local player, resetting it in between, and fails if memory grows or a rebind is lost. Usage: pl_rebindStress [count]");
+	ConsoleRegistrationHelper::AddCommand("pl_updateBench", CPlayerComponent::CmdUpdateBenchmark, VF_NULL, "Times the look and movement update over many players, in the component layout before and after the hot/cold split. Usage: pl_updateBench [players] [frames]");
+	ConsoleRegistrationHelper::AddCommand("pl_inputRecord", CPlayerInputRecorder::CmdRecord, VF_NULL, "Records the local player's input actions. Usage: pl_inputRecord [path]");
+	ConsoleRegistrationHelper::AddCommand("pl_inputStop", CPlayerInputRecorder::CmdStop, VF_NULL, "Stops and saves an input recording, or stops a replay");
+	ConsoleRegistrationHelper::AddCommand("pl_inputReplay", CPlayerInputRecorder::CmdReplay, VF_NULL, "Replays a recorded input file into the player. Usage: pl_inputReplay [path]");
+
+	// Memory
+	ConsoleRegistrationHelper::Register("pl_poolSize", &pl_poolSize, pl_poolSize, VF_NULL, "Most KB the per-player allocation pool takes pages for, pages are only taken as they are needed. 0 uses the heap");
+	ConsoleRegistrationHelper::AddCommand("pl_pool", CPlayerMemoryPool::CmdLog, VF_NULL, "Logs the player memory pool usage, high-water mark and fragmentation");
+	ConsoleRegistrationHelper::Register("pl_spawnPoolSize", &pl_spawnPoolSize, pl_spawnPoolSize, VF_NULL, "Players spawned hidden at level load for gameplay spawns to claim, unless the level folder has a PlayerSpawnPool.xml with a Size attribute");
+	ConsoleRegistrationHelper::AddCommand("pl_spawnPool", CPlayerSpawnPool::CmdLog, VF_NULL, "Logs the player spawn pool usage and claim times");
+	ConsoleRegistrationHelper::AddCommand("pl_spawnPoolClaim", CPlayerSpawnPool::CmdClaim, VF_NULL, "Claims players from the spawn pool in front of the local player. Usage: pl_spawnPoolClaim [count]");
+	ConsoleRegistrationHelper::AddCommand("pl_spawnPoolReturn", CPlayerSpawnPool::CmdReturnAll, VF_NULL, "Returns every claimed pooled player to the spawn pool");
+
+	// Simulation
+	ConsoleRegistrationHelper::Register("pl_fixedStepRate", &pl_fixedStepRate, pl_fixedStepRate, VF_NULL, "Player simulation rate in Hz (e.g. 60 or 120), 0 simulates once per frame with the frame time");
+	ConsoleRegistrationHelper::Register("pl_fixedStepMaxTicks", &pl_fixedStepMaxTicks, pl_fixedStepMaxTicks, VF_NULL, "Maximum fixed simulation ticks per frame, the remaining backlog is dropped");
 }
 
 void CConsoleVariables::UnregisterCVars()
 {
 	IConsole* pConsole = gEnv->pConsole;
+	if (!pConsole)
+		return;
+
 	pConsole->UnregisterVariable("g_WalkSpeed",true);
+
+	// Profiling
+	pConsole->UnregisterVariable("pl_traceCapacity", true);
+	pConsole->RemoveCommand("pl_traceStart");
+	pConsole->RemoveCommand("pl_traceStop");
+	pConsole->RemoveCommand("pl_traceDump");
+	pConsole->UnregisterVariable("pl_statsLogInterval", true);
+	pConsole->RemoveCommand("pl_stats");
+	pConsole->RemoveCommand("pl_statsReset");
+	pConsole->RemoveCommand("pl_allocLog");
+	pConsole->RemoveCommand("pl_allocReset");
+	pConsole->RemoveCommand("pl_allocCheck");
+	pConsole->RemoveCommand("pl_latency");
+	pConsole->RemoveCommand("pl_latencyReset");
+	pConsole->RemoveCommand("pl_memory");
+	pConsole->RemoveCommand("pl_archetypes");
+	pConsole->UnregisterVariable("pl_nodeProfile", true);
+	pConsole->RemoveCommand("pl_nodeStats");
+	pConsole->RemoveCommand("pl_nodeStatsReset");
+
+	// Input
+	pConsole->UnregisterVariable("pl_inputQueue", true);
+	pConsole->UnregisterVariable("pl_rawMouseLook", true);
+	pConsole->UnregisterVariable("pl_stickLookRate", true);
+	pConsole->UnregisterVariable("pl_bindingProfile", true);
+	pConsole->RemoveCommand("pl_rebindStress");
+	pConsole->RemoveCommand("pl_updateBench");
+	pConsole->RemoveCommand("pl_inputRecord");
+	pConsole->RemoveCommand("pl_inputStop");
+	pConsole->RemoveCommand("pl_inputReplay");
+
+	// Memory
+	pConsole->UnregisterVariable("pl_poolSize", true);
+	pConsole->RemoveCommand("pl_pool");
+	pConsole->UnregisterVariable("pl_spawnPoolSize", true);
+	pConsole->RemoveCommand("pl_spawnPool");
+	pConsole->RemoveCommand("pl_spawnPoolClaim");
+	pConsole->RemoveCommand("pl_spawnPoolReturn");
+
+	// Simulation
+	pConsole->UnregisterVariable("pl_fixedStepRate", true);
+	pConsole->UnregisterVariable("pl_fixedStepMaxTicks", true);
 }
@@ -1,17 +1,48 @@
 #pragma once
 
+struct ICVar;
+
 class CConsoleVariables
 {
 public:
 	CConsoleVariables()
 	{
-
+		s_pThis = this;
 	}
 	~CConsoleVariables()
 	{
 		UnregisterCVars();
+		s_pThis = nullptr;
+	}
+
+	static CConsoleVariables& Get()
+	{
+		CRY_ASSERT(s_pThis);
+		return *s_pThis;
 	}
 
 	void RegisterCVars();
 	void UnregisterCVars();
-};
\ No newline at end of file
+
+	// Profiling
+	int pl_traceCapacity = 65536;
+	float pl_statsLogInterval = 0.f;
+	int pl_nodeProfile = 0;
+
+	// Input
+	int pl_inputQueue = 1;
+	int pl_rawMouseLook = 0;
+	float pl_stickLookRate = 1500.f;
+	ICVar* pl_bindingProfile = nullptr;
+
+	// Memory
+	int pl_poolSize = 256;
+	int pl_spawnPoolSize = 0;
+
+	// Simulation
+	float pl_fixedStepRate = 0.f;
+	int pl_fixedStepMaxTicks = 4;
+
+private:
+	static CConsoleVariables* s_pThis;
+};
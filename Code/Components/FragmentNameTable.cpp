@@ -0,0 +1,59 @@
+#include "StdAfx.h"
+#include "FragmentNameTable.h"
+
+#include <CryCore/CryCrc32.h>
+
+CPlayerFragmentNameTable* CPlayerFragmentNameTable::s_pThis = nullptr;
+
+void CPlayerFragmentNameTable::Build(const SControllerDef& controllerDef)
+{
+	if (m_pControllerDef == &controllerDef)
+		return;
+
+	const CTagDefinition& fragmentIds = controllerDef.m_fragmentIDs;
+	const int fragmentCount = fragmentIds.GetNum();
+	if (fragmentCount > static_cast<int>(MaxFragments))
+	{
+		CryLogAlways("[Fragments] The controller definition has %d fragments, only the first %u get ids.", fragmentCount, static_cast<uint32>(MaxFragments));
+	}
+
+	m_names.clear();
+	m_ids.clear();
+	m_names.reserve(min(fragmentCount, static_cast<int>(MaxFragments)));
+	for (int i = 0; i < fragmentCount && i < static_cast<int>(MaxFragments); ++i)
+	{
+		const char* szName = fragmentIds.GetTagName(i);
+		const uint32 nameCrc = CCrc32::ComputeLowercase(szName);
+		const auto range = m_ids.equal_range(nameCrc);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			CryLogAlways("[Fragments] Fragments '%s' and '%s' have the same name CRC 0x%08x, lookups compare the names.", m_names[it->second].c_str(), szName, nameCrc);
+		}
+
+		m_names.emplace_back(szName);
+		m_ids.emplace(nameCrc, static_cast<TPlayerFragmentId>(i));
+	}
+
+	m_pControllerDef = &controllerDef;
+	CryLogAlways("[Fragments] Interned %u fragment names.", static_cast<uint32>(m_names.size()));
+}
+
+TPlayerFragmentId CPlayerFragmentNameTable::Find(const char* szName) const
+{
+	if (!szName || szName[0] == '\0')
+		return InvalidPlayerFragmentId;
+
+	const auto range = m_ids.equal_range(CCrc32::ComputeLowercase(szName));
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (stricmp(m_names[it->second].c_str(), szName) == 0)
+			return it->second;
+	}
+	return InvalidPlayerFragmentId;
+}
+
+const Schematyc::CSharedString& CPlayerFragmentNameTable::GetName(TPlayerFragmentId id) const
+{
+	static const Schematyc::CSharedString s_empty;
+	return id < m_names.size() ? m_names[id] : s_empty;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <ICryMannequin.h>
+#include <CrySchematyc/Utils/SharedString.h>
+
+// Compact Mannequin fragment id, carried by archetypes and flow nodes instead of the fragment name
+typedef uint16 TPlayerFragmentId;
+constexpr TPlayerFragmentId InvalidPlayerFragmentId = 0xFFFF;
+
+////////////////////////////////////////////////////////
+// Plugin-wide table of the fragment names in the player
+// controller definition. Ids are the Mannequin fragment
+// ids, so they can be queued without a name lookup.
+////////////////////////////////////////////////////////
+class CPlayerFragmentNameTable
+{
+public:
+	static constexpr size_t MaxFragments = InvalidPlayerFragmentId;
+
+	CPlayerFragmentNameTable()
+	{
+		s_pThis = this;
+	}
+	~CPlayerFragmentNameTable()
+	{
+		s_pThis = nullptr;
+	}
+
+	static CPlayerFragmentNameTable& Get()
+	{
+		CRY_ASSERT(s_pThis);
+		return *s_pThis;
+	}
+
+	// Interns every fragment of the controller definition the database was loaded with, nothing to do if
+	// the table was already built from it
+	void Build(const SControllerDef& controllerDef);
+	bool IsBuilt() const { return m_pControllerDef != nullptr; }
+
+	// Case insensitive like Mannequin, InvalidPlayerFragmentId if the name is not a fragment. A CRC hit is
+	// confirmed against the interned name, so names with colliding CRCs still resolve to their own id.
+	TPlayerFragmentId Find(const char* szName) const;
+
+	// Shared, properties naming the same fragment can point at this string instead of their own copy
+	const Schematyc::CSharedString& GetName(TPlayerFragmentId id) const;
+	static FragmentID ToFragmentId(TPlayerFragmentId id) { return id == InvalidPlayerFragmentId ? FRAGMENT_ID_INVALID : static_cast<FragmentID>(id); }
+
+	size_t GetCount() const { return m_names.size(); }
+
+private:
+	const SControllerDef* m_pControllerDef = nullptr;
+	std::vector<Schematyc::CSharedString> m_names;         // By id
+	std::unordered_multimap<uint32, TPlayerFragmentId> m_ids; // By lowercase CRC32 of the name, colliding names share a key
+
+	static CPlayerFragmentNameTable* s_pThis;
+};
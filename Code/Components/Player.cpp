@@ -13,7 +13,9 @@
 #include <DefaultComponents/Geometry/AdvancedAnimationComponent.h>
 
 #include <CrySystem/ISystem.h>
+#include <CrySystem/IConsole.h>
 #include <CryInput/IInput.h>
+#include <CryGame/IGameFramework.h>
 
 #include <CryFlowGraph/IFlowSystem.h>
 #include <CryFlowGraph/IFlowBaseNode.h>
@@ -25,11 +27,30 @@
 #include <Cry3DEngine/ISurfaceType.h>
 #include <Cry3DEngine/IMaterial.h>
 #include <string>
+#include <memory>
+#include <CryCore/CryCrc32.h>
+
+#include "Input/BindingProfile.h"
+#include "Input/InputRecorder.h"
+#include "Components/ConsoleVariables.h"
+#include "Components/FragmentNameTable.h"
+#include "Components/PlayerArchetype.h"
+#include "Components/PlayerRegistry.h"
+#include "Components/PlayerSpawnPool.h"
+#include "Profiling/AllocationTracker.h"
+#include "Profiling/FrameStats.h"
+#include "Profiling/LatencyStats.h"
+#include "Profiling/NodeProfiler.h"
+#include "Profiling/TraceRecorder.h"
 
 
 
 namespace
 {
+	static constexpr const char* DefaultBindingCachePath = "%USER%/player_bindings.pbnd";
+	static constexpr const char* AnimationDatabaseFile = "Animations/Mannequin/ADB/FirstPerson.adb";
+	static constexpr const char* ControllerDefinitionFile = "Animations/Mannequin/ADB/FirstPersonControllerDefinition.xml";
+
 	static void RegisterPlayerComponent(Schematyc::IEnvRegistrar& registrar)
 	{
 		Schematyc::CEnvRegistrationScope scope = registrar.Scope(IEntity::GetEntityScopeGUID());
@@ -47,18 +68,11 @@ CPlayerComponent::CPlayerComponent()
 	m_pCameraComponent(nullptr),
 	m_pInputComponent(nullptr),
 	m_pCharacterControllerComponent(nullptr),
-	m_CurrentYaw(IDENTITY),
-	m_CurrentPitch(0.f),
-	m_movementDelta(ZERO),
-	m_MouseDeltaRotation(ZERO),
-	m_currentPlayerState(DEFAULT_PLAYER_STATE),
-	m_currentPlayerStance(DEFAULT_PLAYER_STANCE),
-	m_desiredPlayerStance(DEFAULT_PLAYER_STANCE),
+	m_pInputQueue(new TPlayerInputQueue()),
 	m_CapsuleGroundOffset(DEFAULT_CAPSULE_HEIGHT_OFFSET),
 	m_CameraOffsetCrouching(Vec3(0.f, 0.f, DEFAULT_CAMERA_HEIGHT_CROUCHING)),
 	m_CapsuleHeightStanding(DEFAULT_CAPSULE_HEIGHT_STANDING),
 	m_CapsuleHeightCrouching(DEFAULT_CAPSULE_HEIGHT_CROUCHING),
-	m_CameraEndOffset(Vec3(0.f, 0.f, DEFAULT_CAMERA_HEIGHT_STANDING)),
 	m_CameraOffsetStanding(Vec3(0.f, 0.f, DEFAULT_CAMERA_HEIGHT_STANDING)),
 	m_RotationSpeed(DEFAULT_ROTATION_SPEED),
 	m_WalkSpeed(DEFAULT_SPEED_WALKING),
@@ -70,26 +84,49 @@ CPlayerComponent::CPlayerComponent()
 
 }
 
+CPlayerComponent::~CPlayerComponent()
+{
+	if (CPlayerRegistry* pPlayerRegistry = CPlayerRegistry::GetIfAvailable())
+	{
+		pPlayerRegistry->Unregister(*this);
+	}
+}
+
 /*
 	-------------------------------------------
 	Footstep Sounds & Surface Types Recognition
 	-------------------------------------------
 */
 
+namespace
+{
+	// Surface types are named mat_<surface>, the footstep triggers only use <surface>
+	const char* StripSurfacePrefix(const char* szSurfaceName)
+	{
+		return strncmp(szSurfaceName, "mat_", 4) == 0 ? szSurfaceName + 4 : szSurfaceName;
+	}
+}
+
 void CPlayerComponent::LoadSurfaceTypes()
 {
+	// Every player uses the same table, it is only parsed again once no player holds it
+	static std::weak_ptr<const TSurfaceTypeMap> s_pSharedSurfaceTypes;
+	m_pSurfaceTypes = s_pSharedSurfaceTypes.lock();
+	if (m_pSurfaceTypes)
+		return;
+
 	// Retrieve the assets folder name from the sys_game_folder cvar
 	const ICVar* pGameFolderCVar = gEnv->pConsole->GetCVar("sys_game_folder");
 	if (!pGameFolderCVar)
 	{
-		CryLogAlways("Failed to retrieve sys_game_folder cvar.");
+		PLAYER_LOG("Failed to retrieve sys_game_folder cvar.");
 		return;
 	}
 
 	const string gameFolder = pGameFolderCVar->GetString();
 	if (gameFolder.empty())
 	{
-		CryLogAlways("sys_game_folder cvar is empty.");
+		PLAYER_LOG("sys_game_folder cvar is empty.");
 		return;
 	}
 
@@ -100,11 +137,13 @@ void CPlayerComponent::LoadSurfaceTypes()
 	XmlNodeRef root = gEnv->pSystem->LoadXmlFromFile(surfaceTypesPath.c_str());
 	if (!root)
 	{
-		CryLogAlways("Failed to load SurfaceTypes.xml from path: %s", surfaceTypesPath.c_str());
+		PLAYER_LOG("Failed to load SurfaceTypes.xml from path: %s", surfaceTypesPath.c_str());
 		return;
 	}
 
 	// Parse the XML and populate the map
+	// Trigger ids are resolved here, so a footstep only hashes the surface name
+	std::shared_ptr<TSurfaceTypeMap> pSurfaceTypes = std::allocate_shared<TSurfaceTypeMap>(CPlayerMemoryPoolAllocator<TSurfaceTypeMap>());
 	for (int i = 0; i < root->getChildCount(); ++i)
 	{
 		XmlNodeRef surfaceNode = root->getChild(i);
@@ -113,74 +152,81 @@ void CPlayerComponent::LoadSurfaceTypes()
 			const char* surfaceName = nullptr;
 			if (surfaceNode->getAttr("name", &surfaceName)) // Ensure the second argument matches the expected type
 			{
-				std::string surfaceNameStr = surfaceName; // Ensure surfaceNameStr is a std::string
-				if (surfaceNameStr.find("mat_") == 0) {
-					surfaceNameStr = surfaceNameStr.substr(4); // Remove "mat_"
+				surfaceName = StripSurfacePrefix(surfaceName);
+				const string audioTriggerName = string("pl_footsteps/") + surfaceName;
+				const CryAudio::ControlId audioTriggerId = CryAudio::StringToId(audioTriggerName.c_str());
+				if (audioTriggerId != CryAudio::InvalidControlId)
+				{
+					(*pSurfaceTypes)[CCrc32::ComputeLowercase(surfaceName)] = audioTriggerId;
+				}
+				else
+				{
+					PLAYER_LOG("Invalid audio trigger: %s", audioTriggerName.c_str());
 				}
-				m_surfaceTypes[surfaceNameStr] = "pl_footsteps/" + surfaceNameStr;
 			}
 		}
 	}
 
-	CryLogAlways("Loaded %d surface types.", m_surfaceTypes.size());
+	PLAYER_LOG("Loaded %d surface types.", static_cast<int>(pSurfaceTypes->size()));
+
+	m_pSurfaceTypes = pSurfaceTypes;
+	s_pSharedSurfaceTypes = pSurfaceTypes;
 }
 
 
 
 void CPlayerComponent::OnFootstepEvent(const char* eventName)
 {
+	PLAYER_ALLOC_SCOPE("Player.OnFootstepEvent");
+
+	if (!m_pSurfaceTypes)
+		return;
+
 	// Get the player's position
 	const Vec3 playerPosition = m_pEntity->GetWorldPos();
 
 	// Perform a raycast to detect the surface below the player
 	ray_hit hit;
 	const int rayFlags = rwi_stop_at_pierceable | rwi_colltype_any;
-	if (gEnv->pPhysicalWorld->RayWorldIntersection(
-		playerPosition, Vec3(0, 0, -1) * 1.0f, // Cast a ray downward
-		ent_all, rayFlags, &hit, 1))
+	int hitCount = 0;
+	{
+		PLAYER_TRACE_SCOPE("Physics.FootstepRaycast");
+		PLAYER_STAT_INC(Raycast);
+		hitCount = gEnv->pPhysicalWorld->RayWorldIntersection(
+			playerPosition, Vec3(0, 0, -1) * 1.0f, // Cast a ray downward
+			ent_all, rayFlags, &hit, 1);
+	}
+
+	if (hitCount > 0)
 	{
 		// Get the surface type from the hit
 		const ISurfaceType* pSurfaceType = gEnv->p3DEngine->GetMaterialManager()->GetSurfaceType(hit.surface_idx);
 		if (!pSurfaceType)
 		{
-			CryLogAlways("Failed to retrieve surface type from raycast hit.");
+			PLAYER_LOG("Failed to retrieve surface type from raycast hit.");
 			return;
 		}
 
-		const char* surfaceTypeName = pSurfaceType->GetName();
-		std::string surfaceName = surfaceTypeName;
-		if (surfaceName.find("mat_") == 0)
-		{
-			surfaceName = surfaceName.substr(4); // Remove "mat_"
-		}
+		const char* surfaceName = StripSurfacePrefix(pSurfaceType->GetName());
 
 		// Find the corresponding audio trigger
-		auto it = m_surfaceTypes.find(surfaceName);
-		if (it == m_surfaceTypes.end())
+		auto it = m_pSurfaceTypes->find(CCrc32::ComputeLowercase(surfaceName));
+		if (it == m_pSurfaceTypes->end())
 		{
-			CryLogAlways("No audio trigger found for surface type: %s", surfaceName.c_str());
+			PLAYER_LOG("No audio trigger found for surface type: %s", surfaceName);
 			return;
 		}
 
-		const std::string& audioTriggerName = it->second;
-
 		// Play the audio trigger
 		if (gEnv->pAudioSystem)
 		{
-			CryAudio::ControlId audioTriggerId = CryAudio::StringToId(audioTriggerName.c_str());
-			if (audioTriggerId != CryAudio::InvalidControlId)
-			{
-				gEnv->pAudioSystem->ExecuteTrigger(audioTriggerId, CryAudio::SRequestUserData::GetEmptyObject());
-			}
-			else
-			{
-				CryLogAlways("Invalid audio trigger: %s", audioTriggerName.c_str());
-			}
+			PLAYER_STAT_INC(AudioTrigger);
+			gEnv->pAudioSystem->ExecuteTrigger(it->second, CryAudio::SRequestUserData::GetEmptyObject());
 		}
 	}
 	else
 	{
-		CryLogAlways("No surface detected below the player.");
+		PLAYER_LOG("No surface detected below the player.");
 	}
 }
 
@@ -193,22 +239,73 @@ void CPlayerComponent::OnFootstepEvent(const char* eventName)
 
 void CPlayerComponent::Initialize()
 {
+	// Players spawned for the spawn pool stay hidden and unregistered until claimed, and are never driven by local input
+	const CPlayerSpawnPool* pSpawnPool = CPlayerSpawnPool::GetIfAvailable();
+	m_bSpawnedByPool = pSpawnPool && pSpawnPool->IsSpawning();
+	m_bPooled = m_bSpawnedByPool;
+
 	m_pCameraComponent = m_pEntity->GetOrCreateComponent <Cry::DefaultComponents::CCameraComponent>();
-	m_pInputComponent = m_pEntity->GetOrCreateComponent <Cry::DefaultComponents::CInputComponent>();
 	m_pCharacterControllerComponent = m_pEntity->GetOrCreateComponent <Cry::DefaultComponents::CCharacterControllerComponent>();
 	m_pAdvancedAnimationComponent = m_pEntity->GetOrCreateComponent <Cry::DefaultComponents::CAdvancedAnimationComponent>();
 	m_pAdvancedAnimationComponent->SetDefaultScopeContextName("FirstPersonCharacter");
-	m_pAdvancedAnimationComponent->SetMannequinAnimationDatabaseFile("Animations/Mannequin/ADB/FirstPerson.adb");
-	m_pAdvancedAnimationComponent->SetControllerDefinitionFile("Animations/Mannequin/ADB/FirstPersonControllerDefinition.xml");
+	m_pAdvancedAnimationComponent->SetMannequinAnimationDatabaseFile(AnimationDatabaseFile);
+	m_pAdvancedAnimationComponent->SetControllerDefinitionFile(ControllerDefinitionFile);
 	m_pAdvancedAnimationComponent->SetDefaultFragmentName("Idle");
 	m_pAdvancedAnimationComponent->LoadFromDisk();
 
-	m_pInputComponent = m_pEntity->GetOrCreateComponent<Cry::DefaultComponents::CInputComponent>();
+	// The first player to load the database interns its fragment names for everyone
+	if (const SControllerDef* pControllerDef = gEnv->pGameFramework->GetMannequinInterface().GetAnimationDatabaseManager().LoadControllerDef(ControllerDefinitionFile))
+	{
+		CPlayerFragmentNameTable::Get().Build(*pControllerDef);
+	}
+	else if (!CPlayerFragmentNameTable::Get().IsBuilt())
+	{
+		CryWarning(VALIDATOR_MODULE_GAME, VALIDATOR_ERROR, "[Player] Failed to load %s, animations are queued by name.", ControllerDefinitionFile);
+	}
+
+	if (!m_bSpawnedByPool)
+	{
+		m_pInputComponent = m_pEntity->GetOrCreateComponent<Cry::DefaultComponents::CInputComponent>();
+	}
+	m_pRawMouseLookListener = stl::make_unique<CRawMouseLookListener>(*this);
 
 	// Load surface types
 	LoadSurfaceTypes();
 
 	Reset();
+
+	if (m_bSpawnedByPool)
+	{
+		m_pEntity->Hide(true);
+		return;
+	}
+
+	// Players placed in the level are driven by local input
+	CPlayerRegistry& playerRegistry = CPlayerRegistry::Get();
+	playerRegistry.Register(*this);
+	m_bLocalPlayer = playerRegistry.AssignLocalSlot(*this) != CPlayerRegistry::InvalidLocalSlot;
+}
+
+void CPlayerComponent::ReturnToPool()
+{
+	CPlayerRegistry::Get().Unregister(*this);
+	m_bLocalPlayer = false;
+	m_pRawMouseLookListener->Enable(false);
+	m_pCharacterControllerComponent->SetVelocity(ZERO);
+	m_pEntity->Hide(true);
+	m_bPooled = true;
+}
+
+void CPlayerComponent::ClaimFromPool(const Matrix34& worldTM)
+{
+	// A returned player keeps the state of its last claim, Reset also takes the yaw from the new transform
+	m_bPooled = false;
+	m_pEntity->SetWorldTM(worldTM);
+	Reset();
+	m_pEntity->Hide(false);
+
+	// Pooled players are not local players, they get no local slot
+	CPlayerRegistry::Get().Register(*this);
 }
 
 void CPlayerComponent::RecenterCollider()
@@ -234,6 +331,7 @@ void CPlayerComponent::RecenterCollider()
 		HeighOffset = HeighOffset * 0.5f / physParams.m_radius * 0.5f;
 	}
 
+	PLAYER_STAT_INC(SetTransformMatrix);
 	PCharacterControllerComponent->SetTransformMatrix(Matrix34(IDENTITY, Vec3(0.f, 0.f, 0.005f + HeighOffset)));
 
 	skip = true;
@@ -242,156 +340,623 @@ void CPlayerComponent::RecenterCollider()
 }
 
 
+namespace
+{
+	// In EPlayerAnimation order
+	const std::array<Schematyc::CSharedString CPlayerComponent::*, SPlayerArchetype::AnimationCount> AnimationProperties = { {
+		&CPlayerComponent::m_AnimationIdle, &CPlayerComponent::m_AnimationWalk, &CPlayerComponent::m_AnimationBack, &CPlayerComponent::m_AnimationRun,
+		&CPlayerComponent::m_AnimationJump, &CPlayerComponent::m_AnimationLeft, &CPlayerComponent::m_AnimationRight, &CPlayerComponent::m_AnimationCrouch,
+		&CPlayerComponent::m_AnimationCrouchIdle, &CPlayerComponent::m_AnimationCroucToStand, &CPlayerComponent::m_AnimationStandToCrouch,
+		&CPlayerComponent::m_AnimationWalkLeft, &CPlayerComponent::m_AnimationWalkRight, &CPlayerComponent::m_AnimationRunLeft, &CPlayerComponent::m_AnimationRunRight,
+		&CPlayerComponent::m_AnimationCrouchLeft, &CPlayerComponent::m_AnimationCrouchRight, &CPlayerComponent::m_AnimationCrouchWalk, &CPlayerComponent::m_AnimationCrouchBack
+	} };
+}
+
+void CPlayerComponent::ApplyArchetype()
+{
+	SPlayerArchetype archetype;
+	archetype.walkSpeed = m_WalkSpeed;
+	archetype.runSpeed = m_RunSpeed;
+	archetype.jumpHeight = m_JumpHeight;
+	archetype.rotationSpeed = m_RotationSpeed;
+	archetype.pitchMax = m_RotationLimitsMaxPitch;
+	archetype.pitchMin = m_RotationLimitsMinPitch;
+	archetype.cameraOffsetStanding = m_CameraOffsetStanding;
+	archetype.cameraOffsetCrouching = m_CameraOffsetCrouching;
+	archetype.capsuleHeightStanding = m_CapsuleHeightStanding;
+	archetype.capsuleHeightCrouching = m_CapsuleHeightCrouching;
+	archetype.capsuleGroundOffset = m_CapsuleGroundOffset;
+
+	const CPlayerFragmentNameTable& fragmentNames = CPlayerFragmentNameTable::Get();
+	for (size_t i = 0; i < SPlayerArchetype::AnimationCount; ++i)
+	{
+		// Only the archetype holds the resolved fragment, the property keeps the name as it was typed in the editor
+		const Schematyc::CSharedString& animationName = this->*AnimationProperties[i];
+		archetype.animations[i] = fragmentNames.Find(animationName.c_str());
+		if (archetype.animations[i] == InvalidPlayerFragmentId && !animationName.empty() && fragmentNames.IsBuilt())
+		{
+			PLAYER_LOG("Animation '%s' is not a fragment in %s.", animationName.c_str(), AnimationDatabaseFile);
+		}
+	}
+
+	m_pArchetype = CPlayerArchetypeRegistry::Get().Intern(archetype);
+}
+
 void CPlayerComponent::Reset()
 {
+	ApplyArchetype();
+
 	// Reset Input
-	m_movementDelta = ZERO;
-	m_MouseDeltaRotation = ZERO;
-	m_CurrentYaw = Quat::CreateRotationZ(m_pEntity->GetWorldRotation().GetRotZ());
-	m_CurrentPitch = 0.f;
+	m_pInputQueue->Clear();
+	m_hot.movementDelta = ZERO;
+	m_MouseDeltaAccumulator.Clear();
+	m_lookStickDeflection = ZERO;
+	m_hot.currentYaw = Quat::CreateRotationZ(m_pEntity->GetWorldRotation().GetRotZ());
+	m_hot.currentPitch = 0.f;
+
+	// Reset Fixed Step Interpolation
+	m_hot.previousYaw = m_hot.currentYaw;
+	m_hot.previousPitch = m_hot.currentPitch;
+	m_hot.simulationAccumulator = 0.f;
+	m_hot.pendingInputTicks.fill(0);
 
 	// Reset Player State
-	m_currentPlayerState = EPlayerState::Walking;
+	m_hot.playerState = EPlayerState::Walking;
 
-	InitializeInput();
+	// Pooled players have no input component, they are driven by whoever claims them
+	if (m_pInputComponent)
+	{
+		InitializeInput();
+	}
 
-	m_currentPlayerStance = EPlayerStance::Standing;
-	m_desiredPlayerStance = m_currentPlayerStance;
+	m_hot.stance = EPlayerStance::Standing;
+	m_hot.desiredStance = m_hot.stance;
 
 	// Reset Camera Lerp
-	m_CameraEndOffset = m_CameraOffsetStanding;
+	m_hot.cameraEndOffset = m_pArchetype->cameraOffsetStanding;
 }
 
 void CPlayerComponent::InitializeInput()
 {
-	m_pInputComponent->RegisterAction("player", "moveforward", [this](int activationMode, float value) 
+	// Actions are registered once per component. Later resets keep the keys rebound since then,
+	// the shared binding table always holds what is bound on the action map.
+	if (m_bInputActionsRegistered)
+		return;
+
+	for (size_t i = 0; i < PlayerInput::ActionCount; ++i)
+	{
+		// Captures stay within the std::function small buffer, registering does not allocate a closure
+		const EPlayerInputAction action = static_cast<EPlayerInputAction>(i);
+		m_pInputComponent->RegisterAction(PlayerInput::ActionGroup, PlayerInput::GetActionName(action), [this, action](int activationMode, float value) { OnInputCallback(action, activationMode, value); });
+	}
+	m_bInputActionsRegistered = true;
+
+	// The action map is shared by all players, the first one loads the profile and binds it
+	if (!CPlayerActionMapBindings::Get().IsEmpty())
+		return;
+
+	CPlayerBindingProfile& bindingProfile = CPlayerBindingProfile::Get();
+	if (!bindingProfile.IsLoaded())
+	{
+		bindingProfile.Load(CConsoleVariables::Get().pl_bindingProfile->GetString(), DefaultBindingCachePath);
+	}
+
+	ApplyBindingProfile(bindingProfile);
+}
+
+EPlayerBindResult CPlayerComponent::BindActionKey(EPlayerInputAction action, EKeyId keyId)
+{
+	if (!m_pInputComponent)
+		return EPlayerBindResult::UnsupportedKey;
+
+	return CPlayerActionMapBindings::Get().BindActionKey(*m_pInputComponent, action, keyId);
+}
+
+bool CPlayerComponent::ApplyBindingProfile(const CPlayerBindingProfile& profile)
+{
+	return m_pInputComponent && CPlayerActionMapBindings::Get().ApplyProfile(*m_pInputComponent, profile);
+}
+
+void CPlayerComponent::OnBindingProfileChanged(ICVar* pCVar)
+{
+	CPlayerBindingProfile& bindingProfile = CPlayerBindingProfile::Get();
+	bindingProfile.Load(pCVar->GetString(), DefaultBindingCachePath);
+
+	// Choosing another profile is an explicit request, it replaces keys rebound since the map was bound.
+	// The bindings are the action map's, any player with registered actions applies them for all.
+	if (CPlayerRegistry* pPlayerRegistry = CPlayerRegistry::GetIfAvailable())
+	{
+		for (CPlayerComponent* pPlayer : pPlayerRegistry->GetPlayers())
 		{
-			m_movementDelta.y = value;
-			if (activationMode == (int)eAAM_OnPress)
+			if (pPlayer->m_bInputActionsRegistered)
 			{
-				m_Walk = 1;
+				pPlayer->ApplyBindingProfile(bindingProfile);
+				break;
 			}
-			else if (activationMode == eAAM_OnRelease)
+		}
+	}
+}
+
+void CPlayerComponent::CmdRebindStress(IConsoleCmdArgs* pArgs)
+{
+	const int rebindCount = pArgs->GetArgCount() > 1 ? max(atoi(pArgs->GetArg(1)), 2) : 10000;
+
+	CPlayerComponent* pPlayerComponent = CPlayerRegistry::Get().GetLocalPlayer();
+	if (!pPlayerComponent)
+	{
+		CryLogAlways("[RebindStress] Failed: There is no local player.");
+		return;
+	}
+
+	const EKeyId originalKeyId = pPlayerComponent->GetKeyBoundToAction(EPlayerInputDevice::KeyboardMouse, EPlayerInputAction::MoveForward);
+	const EKeyId alternateKeyId = originalKeyId == eKI_Up ? eKI_W : eKI_Up;
+
+	// The first round trip may create the action map entries, memory is measured from there on
+	pPlayerComponent->BindActionKey(EPlayerInputAction::MoveForward, alternateKeyId);
+	pPlayerComponent->BindActionKey(EPlayerInputAction::MoveForward, originalKeyId);
+	const CPlayerAllocationTracker::SCounters begin = CPlayerAllocationTracker::SampleModuleCounters();
+
+	// Resetting the player in between must neither stack bindings nor undo the rebind
+	int keptRebinds = 0;
+	for (int i = 0; i < rebindCount; ++i)
+	{
+		const EKeyId keyId = (i & 1) == 0 ? alternateKeyId : originalKeyId;
+		pPlayerComponent->BindActionKey(EPlayerInputAction::MoveForward, keyId);
+		pPlayerComponent->Reset();
+		keptRebinds += pPlayerComponent->GetKeyBoundToAction(EPlayerInputDevice::KeyboardMouse, EPlayerInputAction::MoveForward) == keyId ? 1 : 0;
+	}
+	pPlayerComponent->BindActionKey(EPlayerInputAction::MoveForward, originalKeyId);
+
+	const CPlayerAllocationTracker::SCounters end = CPlayerAllocationTracker::SampleModuleCounters();
+	const long long bytesDelta = static_cast<long long>(end.liveBytes) - static_cast<long long>(begin.liveBytes);
+	const bool bPassed = bytesDelta <= 0 && keptRebinds == rebindCount;
+	CryLogAlways("[RebindStress] %s: %d rebinds, %d kept across Reset, live bytes %+lld", bPassed ? "PASSED" : "FAILED", rebindCount, keptRebinds, bytesDelta);
+}
+
+namespace
+{
+	// Member order of the component before the hot/cold split: the runtime state, the inline input queue and binding
+	// table, then the properties the update reads, then the animation names
+	struct SPreSplitPlayer
+	{
+		std::array<uint8, sizeof(IEntityComponent)> entityComponent;
+		float movementSpeed;
+		std::array<void*, 4> components;
+		Quat currentYaw;
+		float currentPitch;
+		float simulationAccumulator;
+		std::array<int64, static_cast<size_t>(EPlayerLatencySink::Count)> pendingInputTicks;
+		Vec2 movementDelta;
+		CMouseDeltaAccumulator mouseDeltaAccumulator;
+		void* pRawMouseLookListener;
+		CPlayerComponent::EPlayerState playerState;
+		CPlayerComponent::EPlayerStance stance;
+		CPlayerComponent::EPlayerStance desiredStance;
+		Vec3 cameraEndOffset;
+		TPlayerInputQueue inputQueue;
+		CPlayerBindingTable bindingTable;
+		bool bInputActionsRegistered;
+		Vec3 cameraOffsetStanding;
+		float rotationSpeed;
+		float pitchMin;
+		float pitchMax;
+		float runSpeed;
+		float walkSpeed;
+		float jumpHeight;
+		Vec3 cameraOffsetCrouching;
+		float capsuleHeightStanding;
+		float capsuleHeightCrouching;
+		float capsuleGroundOffset;
+		Schematyc::CSharedString tag;
+		std::array<float, 6> animationState;
+		std::array<Schematyc::CSharedString, SPlayerArchetype::AnimationCount> animationNames;
+	};
+
+	// The component as it is now: the hot state and the archetype pointer first, everything else behind them
+	struct SSplitPlayer
+	{
+		std::array<uint8, sizeof(IEntityComponent)> entityComponent;
+		CPlayerComponent::SHotState hot;
+		std::shared_ptr<const SPlayerArchetype> pArchetype;
+		std::array<uint8, sizeof(CPlayerComponent) - sizeof(IEntityComponent) - sizeof(CPlayerComponent::SHotState) - sizeof(std::shared_ptr<const SPlayerArchetype>)> rest;
+	};
+}
+
+void CPlayerComponent::CmdUpdateBenchmark(IConsoleCmdArgs* pArgs)
+{
+	const int playerCount = pArgs->GetArgCount() > 1 ? max(atoi(pArgs->GetArg(1)), 1) : 10000;
+	const int frameCount = pArgs->GetArgCount() > 2 ? max(atoi(pArgs->GetArg(2)), 1) : 100;
+
+	SPlayerArchetype archetype;
+	archetype.walkSpeed = DEFAULT_SPEED_WALKING;
+	archetype.runSpeed = DEFAULT_SPEED_RUNNING;
+	archetype.rotationSpeed = DEFAULT_ROTATION_SPEED;
+	archetype.pitchMax = DEFAULT_ROT_LIMIT_PITCH_MAX;
+	archetype.pitchMin = DEFAULT_ROT_LIMIT_PITCH_MIN;
+	const std::shared_ptr<const SPlayerArchetype> pArchetype = std::make_shared<const SPlayerArchetype>(archetype);
+
+	// One allocation per player like entity components, interleaved so neither layout gets the more compact heap
+	std::vector<std::unique_ptr<SPreSplitPlayer>> preSplitPlayers(playerCount);
+	std::vector<std::unique_ptr<SSplitPlayer>> splitPlayers(playerCount);
+	for (int i = 0; i < playerCount; ++i)
+	{
+		const EPlayerState playerState = (i & 1) ? EPlayerState::Sprinting : EPlayerState::Walking;
+
+		preSplitPlayers[i].reset(new SPreSplitPlayer());
+		SPreSplitPlayer& preSplitPlayer = *preSplitPlayers[i];
+		preSplitPlayer.currentYaw = IDENTITY;
+		preSplitPlayer.currentPitch = 0.f;
+		preSplitPlayer.movementDelta = Vec2(1.f, 0.5f);
+		preSplitPlayer.playerState = playerState;
+		preSplitPlayer.rotationSpeed = archetype.rotationSpeed;
+		preSplitPlayer.pitchMax = archetype.pitchMax;
+		preSplitPlayer.pitchMin = archetype.pitchMin;
+		preSplitPlayer.walkSpeed = archetype.walkSpeed;
+		preSplitPlayer.runSpeed = archetype.runSpeed;
+
+		splitPlayers[i].reset(new SSplitPlayer());
+		SSplitPlayer& splitPlayer = *splitPlayers[i];
+		splitPlayer.hot.movementDelta = Vec2(1.f, 0.5f);
+		splitPlayer.hot.playerState = playerState;
+		splitPlayer.pArchetype = pArchetype;
+	}
+
+	const Vec2 mouseDelta(3.f, -1.f);
+	Vec3 checksum(ZERO);
+
+	// The look and velocity math of UpdateRotation and UpdateMovement, on the fields the component had before the split
+	int64 startTicks = CryGetTicks();
+	for (int frame = 0; frame < frameCount; ++frame)
+	{
+		for (const std::unique_ptr<SPreSplitPlayer>& pPlayer : preSplitPlayers)
+		{
+			SPreSplitPlayer& player = *pPlayer;
+			player.currentYaw *= Quat::CreateRotationZ(mouseDelta.x * player.rotationSpeed);
+			player.currentPitch = crymath::clamp(player.currentPitch + mouseDelta.y * player.rotationSpeed, player.pitchMax, player.pitchMin);
+
+			Vec3 velocity = Vec3(player.movementDelta.x, player.movementDelta.y, 0.0f);
+			velocity.normalize();
+			checksum += player.currentYaw * velocity * (player.playerState == EPlayerState::Sprinting ? player.runSpeed : player.walkSpeed);
+		}
+	}
+	const int64 preSplitTicks = CryGetTicks() - startTicks;
+
+	// The same update through the hot state and the archetype, as the component runs it
+	startTicks = CryGetTicks();
+	for (int frame = 0; frame < frameCount; ++frame)
+	{
+		for (const std::unique_ptr<SSplitPlayer>& pPlayer : splitPlayers)
+		{
+			SHotState& hot = pPlayer->hot;
+			const SPlayerArchetype& playerArchetype = *pPlayer->pArchetype;
+			hot.ApplyLook(mouseDelta, playerArchetype);
+
+			Vec3 velocity = Vec3(hot.movementDelta.x, hot.movementDelta.y, 0.0f);
+			velocity.normalize();
+			checksum += hot.currentYaw * velocity * hot.GetMoveSpeed(playerArchetype);
+		}
+	}
+	const int64 splitTicks = CryGetTicks() - startTicks;
+
+	const double ticksPerSec = static_cast<double>(max(CryGetTicksPerSec(), static_cast<int64>(1)));
+	const double updateCount = static_cast<double>(playerCount) * static_cast<double>(frameCount);
+	CryLogAlways("[UpdateBench] %d players, %d frames (checksum %.1f)", playerCount, frameCount, checksum.GetLength());
+	CryLogAlways("[UpdateBench] Before split: %8.3f ms, %6.2f ns per player update, %5u bytes per player",
+		preSplitTicks * 1000.0 / ticksPerSec, preSplitTicks * 1e9 / ticksPerSec / updateCount, static_cast<uint32>(sizeof(SPreSplitPlayer)));
+	CryLogAlways("[UpdateBench] After split:  %8.3f ms, %6.2f ns per player update, %5u bytes per player, %u of them hot",
+		splitTicks * 1000.0 / ticksPerSec, splitTicks * 1e9 / ticksPerSec / updateCount, static_cast<uint32>(sizeof(SSplitPlayer)), static_cast<uint32>(sizeof(SHotState)));
+}
+
+void CPlayerComponent::CaptureInputStartState(SPlayerInputStartState& state) const
+{
+	state.position = m_pEntity->GetWorldPos();
+	state.rotation = m_pEntity->GetWorldRotation();
+	state.yaw = m_hot.currentYaw;
+	state.velocity = m_pCharacterControllerComponent->GetVelocity();
+	state.movementDelta = m_hot.movementDelta;
+	state.lookStickDeflection = m_lookStickDeflection;
+	state.pitch = m_hot.currentPitch;
+	state.reserved = 0;
+}
+
+void CPlayerComponent::RestoreInputStartState(const SPlayerInputStartState& state)
+{
+	PLAYER_STAT_INC(SetTransformMatrix);
+	m_pEntity->SetWorldTM(Matrix34::Create(Vec3(1.f), state.rotation, state.position));
+	m_hot.currentYaw = state.yaw;
+	m_hot.currentPitch = state.pitch;
+	m_hot.previousYaw = state.yaw;
+	m_hot.previousPitch = state.pitch;
+	m_hot.movementDelta = state.movementDelta;
+	m_lookStickDeflection = state.lookStickDeflection;
+
+	PLAYER_STAT_INC(SetVelocity);
+	m_pCharacterControllerComponent->SetVelocity(state.velocity);
+
+	// Nothing sampled before the replay may leak into its first frame
+	m_pInputQueue->Clear();
+	m_MouseDeltaAccumulator.Clear();
+	m_hot.simulationAccumulator = 0.f;
+}
+
+void CPlayerComponent::OnInputCallback(EPlayerInputAction action, int activationMode, float value)
+{
+	// Pooled players are hidden and take no input
+	if (m_bPooled)
+		return;
+
+	CPlayerInputRecorder& inputRecorder = CPlayerInputRecorder::Get();
+
+	// Live input is ignored while a recording is replayed into this player
+	if (inputRecorder.IsReplaying(GetEntityId()))
+		return;
+
+	// The raw listener already took this motion from the input event
+	if (PlayerInput::IsLookAction(action) && m_pRawMouseLookListener && m_pRawMouseLookListener->IsEnabled())
+		return;
+
+	inputRecorder.Record(*this, action, activationMode, value);
+
+	if (CConsoleVariables::Get().pl_inputQueue == 0)
+	{
+		StampInputArrival(action, CryGetTicks());
+		HandleInputAction(action, activationMode, value);
+		return;
+	}
+
+	SPlayerInputEvent inputEvent;
+	inputEvent.timestamp = CryGetTicks();
+	inputEvent.value = value;
+	inputEvent.activationMode = static_cast<uint16>(activationMode);
+	inputEvent.action = action;
+
+	// Only the update may pop, so a full queue drops the event rather than draining it from the producer side
+	if (!m_pInputQueue->TryPush(inputEvent))
+	{
+		PLAYER_STAT_INC(InputQueueOverflow);
+	}
+}
+
+void CPlayerComponent::OnRawLookInput(EPlayerInputAction action, float value)
+{
+	CPlayerInputRecorder& inputRecorder = CPlayerInputRecorder::Get();
+	if (inputRecorder.IsReplaying(GetEntityId()))
+		return;
+
+	inputRecorder.Record(*this, action, eAAM_Always, value);
+
+	// Look goes straight into the accumulator, the same as HandleInputAction does for the callbacks
+	StampInputArrival(action, CryGetTicks());
+	m_MouseDeltaAccumulator.Add(action == EPlayerInputAction::Pitch ? Vec2(-value, 0.f) : Vec2(0.f, -value));
+}
+
+void CPlayerComponent::DrainInputQueue()
+{
+	PLAYER_TRACE_SCOPE("Player.DrainInputQueue");
+
+	SPlayerInputEvent inputEvent;
+	while (m_pInputQueue->TryPop(inputEvent))
+	{
+		StampInputArrival(inputEvent.action, inputEvent.timestamp);
+		HandleInputAction(inputEvent.action, inputEvent.activationMode, inputEvent.value);
+	}
+}
+
+void CPlayerComponent::StampInputArrival(EPlayerInputAction action, int64 ticks)
+{
+	auto stamp = [this, ticks](EPlayerLatencySink sink)
+	{
+		int64& pendingTicks = m_hot.pendingInputTicks[static_cast<size_t>(sink)];
+		if (pendingTicks == 0)
+		{
+			pendingTicks = ticks;
+		}
+	};
+
+	switch (action)
+	{
+	case EPlayerInputAction::Yaw:
+	case EPlayerInputAction::Pitch:
+	case EPlayerInputAction::YawStick:
+	case EPlayerInputAction::PitchStick:
+		stamp(EPlayerLatencySink::Rotation);
+		stamp(EPlayerLatencySink::CameraTransform);
+		break;
+
+	case EPlayerInputAction::MoveForward:
+	case EPlayerInputAction::MoveBack:
+	case EPlayerInputAction::MoveLeft:
+	case EPlayerInputAction::MoveRight:
+	case EPlayerInputAction::Sprint:
+		stamp(EPlayerLatencySink::Velocity);
+		break;
+	}
+}
+
+void CPlayerComponent::OnLatencySinkWritten(EPlayerLatencySink sink)
+{
+	int64& pendingTicks = m_hot.pendingInputTicks[static_cast<size_t>(sink)];
+	if (pendingTicks == 0)
+		return;
+
+	const int64 writeTicks = CryGetTicks();
+	CPlayerLatencyStats::Get().AddSample(sink, pendingTicks, writeTicks);
+
+	if (sink == EPlayerLatencySink::CameraTransform && CPlayerTraceRecorder::Get().IsRecording())
+	{
+		CPlayerTraceRecorder::Get().RecordAsync("Latency.LookToCamera", GetEntityId(), pendingTicks, writeTicks);
+	}
+
+	pendingTicks = 0;
+}
+
+void CPlayerComponent::HandleInputAction(EPlayerInputAction action, int activationMode, float value)
+{
+	PLAYER_TRACE_SCOPE(PlayerInput::GetActionTraceName(action));
+	PLAYER_ALLOC_SCOPE(PlayerInput::GetActionTraceName(action));
+
+	switch (action)
+	{
+	case EPlayerInputAction::MoveForward:
+		{
+			// Analog axes (the Oculus stick) carry both directions, negative values move back
+			const bool bWasBack = m_hot.movementDelta.y < 0.f;
+			m_hot.movementDelta.y = value;
+			if (activationMode == eAAM_OnRelease || value == 0.f)
 			{
-				m_pAdvancedAnimationComponent->QueueFragment(m_AnimationIdle);
+				QueueAnimation(EPlayerAnimation::Idle);
+				(bWasBack ? m_Back : m_Walk) = 0;
+			}
+			else if (value < 0.f)
+			{
+				if (m_Back == 0)
+				{
+					QueueAnimation(EPlayerAnimation::Back);
+				}
+				m_Back = 1;
 				m_Walk = 0;
 			}
-		});
-	m_pInputComponent->BindAction("player", "moveforward", eAID_KeyboardMouse, eKI_W);
+			else if (activationMode == (int)eAAM_OnPress || bWasBack)
+			{
+				m_Walk = 1;
+				m_Back = 0;
+			}
+		}
+		break;
 
-	m_pInputComponent->RegisterAction("player", "moveback", [this](int activationMode, float value) 
+	case EPlayerInputAction::MoveBack:
 		{
 			if (activationMode == (int)eAAM_OnPress)
 			{
-				m_pAdvancedAnimationComponent->QueueFragment(m_AnimationBack);
+				QueueAnimation(EPlayerAnimation::Back);
 				m_Back = 1;
 			}
 			else if (activationMode == eAAM_OnRelease)
 			{
-				m_pAdvancedAnimationComponent->QueueFragment(m_AnimationIdle);
+				QueueAnimation(EPlayerAnimation::Idle);
 				m_Back = 0;
 			}
 
-			m_movementDelta.y = -value; 
-		});
-	m_pInputComponent->BindAction("player", "moveback", eAID_KeyboardMouse, eKI_S);
+			m_hot.movementDelta.y = -value; 
+		}
+		break;
 
-	m_pInputComponent->RegisterAction("player", "moveleft", [this](int activationMode, float value) 
+	case EPlayerInputAction::MoveLeft:
 		{
-			m_movementDelta.x = -value; 
+			m_hot.movementDelta.x = -value; 
 			if (activationMode == (int)eAAM_OnPress)
 			{
-				m_pAdvancedAnimationComponent->QueueFragment(m_AnimationLeft);
+				QueueAnimation(EPlayerAnimation::Left);
 				m_Left = 1;
 			}
 			else if (activationMode == eAAM_OnRelease)
 			{
-				m_pAdvancedAnimationComponent->QueueFragment(m_AnimationIdle);
+				QueueAnimation(EPlayerAnimation::Idle);
 				m_Left = 0;
 			}
-		});
-	m_pInputComponent->BindAction("player", "moveleft", eAID_KeyboardMouse, eKI_A);
+		}
+		break;
 
-	m_pInputComponent->RegisterAction("player", "moveright", [this](int activationMode, float value) 
+	case EPlayerInputAction::MoveRight:
 		{
-			m_movementDelta.x = value; 
-			if (activationMode == (int)eAAM_OnPress)
+			// Analog axes (the Oculus stick) carry both directions, negative values move left
+			const bool bWasLeft = m_hot.movementDelta.x < 0.f;
+			m_hot.movementDelta.x = value;
+			if (activationMode == eAAM_OnRelease || value == 0.f)
 			{
-				m_pAdvancedAnimationComponent->QueueFragment(Schematyc::CSharedString(m_AnimationRight.c_str()));
-				m_Right = 1;
+				QueueAnimation(EPlayerAnimation::Idle);
+				(bWasLeft ? m_Left : m_Right) = 0;
 			}
-			else if (activationMode == eAAM_OnRelease)
+			else if (value < 0.f)
 			{
-				m_pAdvancedAnimationComponent->QueueFragment(m_AnimationIdle);
+				if (m_Left == 0)
+				{
+					QueueAnimation(EPlayerAnimation::Left);
+				}
+				m_Left = 1;
 				m_Right = 0;
 			}
-		});
-	m_pInputComponent->BindAction("player", "moveright", eAID_KeyboardMouse, eKI_D);
+			else if (activationMode == (int)eAAM_OnPress || bWasLeft)
+			{
+				QueueAnimation(EPlayerAnimation::Right);
+				m_Right = 1;
+				m_Left = 0;
+			}
+		}
+		break;
+
+	case EPlayerInputAction::Yaw:
+		{
+			m_MouseDeltaAccumulator.Add(Vec2(0.f, -value));
+		}
+		break;
+
+	case EPlayerInputAction::Pitch:
+		{
+			m_MouseDeltaAccumulator.Add(Vec2(-value, 0.f));
+		}
+		break;
 
-	m_pInputComponent->RegisterAction("Player", "yaw", [this](int activationMode, float value) {m_MouseDeltaRotation.y = -value;});
-	m_pInputComponent->BindAction("Player", "yaw", eAID_KeyboardMouse, eKI_MouseY);
+	case EPlayerInputAction::YawStick:
+		{
+			m_lookStickDeflection.y = -value;
+		}
+		break;
 
-	m_pInputComponent->RegisterAction("Player", "pitch", [this](int activationMode, float value) {m_MouseDeltaRotation.x = -value;});
-	m_pInputComponent->BindAction("Player", "pitch", eAID_KeyboardMouse, eKI_MouseX);
+	case EPlayerInputAction::PitchStick:
+		{
+			m_lookStickDeflection.x = -value;
+		}
+		break;
 
-	m_pInputComponent->RegisterAction("player", "sprint", [this](int activationMode, float value) 
+	case EPlayerInputAction::Sprint:
 		{
 			if (activationMode == (int)eAAM_OnPress)
 			{
-				m_currentPlayerState = EPlayerState::Sprinting;
-				m_pAdvancedAnimationComponent->QueueFragment(m_AnimationRun);
+				m_hot.playerState = EPlayerState::Sprinting;
+				QueueAnimation(EPlayerAnimation::Run);
 				m_Run = 1;
 			}
 			else if (activationMode == eAAM_OnRelease)
 			{
-				m_currentPlayerState = EPlayerState::Walking;
+				m_hot.playerState = EPlayerState::Walking;
 				m_Run = 0;
 			}
-		});
-	m_pInputComponent->BindAction("player", "sprint", eAID_KeyboardMouse, eKI_LShift);
+		}
+		break;
 
-	m_pInputComponent->RegisterAction("player", "jump", [this](int activationMode, float value) 
+	case EPlayerInputAction::Jump:
 		{
 			if (m_pCharacterControllerComponent->IsOnGround())
 			{
-				m_pCharacterControllerComponent->AddVelocity(Vec3(0, 0, m_JumpHeight));
+				m_pCharacterControllerComponent->AddVelocity(Vec3(0, 0, m_pArchetype->jumpHeight));
 			}
 			if (activationMode == (int)eAAM_OnPress)
 			{
-				m_currentPlayerState = EPlayerState::Jump;
-				m_pAdvancedAnimationComponent->QueueFragment(Schematyc::CSharedString(m_AnimationJump.c_str()));
+				m_hot.playerState = EPlayerState::Jump;
+				QueueAnimation(EPlayerAnimation::Jump);
 			}
-		});
-	m_pInputComponent->BindAction("player", "crouch", eAID_KeyboardMouse, eKI_Space);
+		}
+		break;
 
-	m_pInputComponent->RegisterAction("player", "crouch", [this](int activationMode, float value)
+	case EPlayerInputAction::Crouch:
 		{
 			if (activationMode == (int)eAAM_OnPress)
 			{
-				m_desiredPlayerStance = EPlayerStance::Crouching;
-				m_pAdvancedAnimationComponent->QueueFragment(m_AnimationCrouch);
+				m_hot.desiredStance = EPlayerStance::Crouching;
+				QueueAnimation(EPlayerAnimation::Crouch);
 
 				m_Crouch = 1;
 			}
 			else if (activationMode == eAAM_OnRelease)
 			{
-				m_desiredPlayerStance = EPlayerStance::Standing;
+				m_hot.desiredStance = EPlayerStance::Standing;
 				m_Crouch = 0;
 			}
-
-			/*if (m_pCharacterControllerComponent->IsOnGround())
-			{
-				m_pCharacterControllerComponent->AddVelocity(Vec3(0, 0, m_JumpHeight));
-			}
-			if (activationMode == (int)eAAM_OnPress)
-			{
-				m_currentPlayerState = EPlayerState::Jump;
-				m_pAdvancedAnimationComponent->QueueFragment("Jump");
-			} */
-		});
-	m_pInputComponent->BindAction("player", "crouch", eAID_KeyboardMouse, eKI_C);
-
-}
+		}
+		break;
+	}
+}
 
 Cry::Entity::EventFlags CPlayerComponent::GetEventMask() const
 {
@@ -415,12 +980,44 @@ void CPlayerComponent::ProcessEvent(const SEntityEvent& eventParam)
 
 	case Cry::Entity::EEvent::Update:
 	{
+		if (m_bPooled)
+			break;
+
+		PLAYER_TRACE_SCOPE("Player.Update");
+		PLAYER_ALLOC_SCOPE("Player.Update");
 		const float frametime = eventParam.fParam[0];
-		TryUpdateStance();
-		UpdateMovement();
-		UpdateCamera(frametime);
-		UpdateRotation();
-	
+
+		// Input: replayed and queued actions
+		CPlayerInputRecorder::Get().UpdateReplay(*this);
+		DrainInputQueue();
+
+		// A stick reports how far it is deflected, not how far it moved, so it turns the player at a rate
+		if (!m_lookStickDeflection.IsZero())
+		{
+			m_MouseDeltaAccumulator.Add(m_lookStickDeflection * (CConsoleVariables::Get().pl_stickLookRate * frametime));
+		}
+
+		// Raw mouse motion is not per player, only the local player turns with it
+		m_pRawMouseLookListener->Enable(m_bLocalPlayer && CConsoleVariables::Get().pl_rawMouseLook != 0);
+
+		if (CConsoleVariables::Get().pl_fixedStepRate > 0.f)
+		{
+			// Look, stance and movement run in fixed ticks, the view is interpolated between the last two
+			UpdateFixedStep(frametime);
+		}
+		else
+		{
+			// Look: yaw and pitch from this frame's deltas, before movement reads the yaw
+			UpdateRotation();
+
+			// Simulation: stance and movement
+			TryUpdateStance();
+			UpdateMovement();
+
+			// Camera is written last so the view submitted this frame carries this frame's look
+			UpdateCamera(frametime, m_hot.currentPitch);
+			OnLatencySinkWritten(EPlayerLatencySink::CameraTransform);
+		}
 	}
 	break;
 
@@ -442,37 +1039,107 @@ void CPlayerComponent::ProcessEvent(const SEntityEvent& eventParam)
 
 void CPlayerComponent::UpdateMovement()
 {
+	PLAYER_TRACE_SCOPE("Player.UpdateMovement");
+
 	// Player Movement
-	Vec3 velocity = Vec3(m_movementDelta.x, m_movementDelta.y, 0.0f);
+	Vec3 velocity = Vec3(m_hot.movementDelta.x, m_hot.movementDelta.y, 0.0f);
 	velocity.normalize();
-	float playerMoveSpeed = m_currentPlayerState == EPlayerState::Sprinting ? m_RunSpeed : m_WalkSpeed;
-	m_pCharacterControllerComponent->SetVelocity(m_pEntity->GetWorldRotation() * velocity * playerMoveSpeed);
+	const float playerMoveSpeed = m_hot.GetMoveSpeed(*m_pArchetype);
+	PLAYER_STAT_INC(SetVelocity);
+	m_pCharacterControllerComponent->SetVelocity(m_hot.currentYaw * velocity * playerMoveSpeed);
+	OnLatencySinkWritten(EPlayerLatencySink::Velocity);
+}
+
+void CPlayerComponent::UpdateFixedStep(float frametime)
+{
+	const CConsoleVariables& cvars = CConsoleVariables::Get();
+	const float tickTime = 1.f / cvars.pl_fixedStepRate;
+	const int maxTicks = max(cvars.pl_fixedStepMaxTicks, 1);
+
+	m_hot.simulationAccumulator += frametime;
+
+	int tickCount = 0;
+	while (m_hot.simulationAccumulator >= tickTime && tickCount < maxTicks)
+	{
+		// Look deltas gathered since the last tick go into the first tick of the frame
+		SimulateTick(tickCount == 0 ? m_MouseDeltaAccumulator.Consume() : Vec2(ZERO));
+		m_hot.simulationAccumulator -= tickTime;
+		++tickCount;
+	}
+
+	if (m_hot.simulationAccumulator >= tickTime)
+	{
+		// Drop the backlog instead of catching up over the next frames
+		m_hot.simulationAccumulator = fmodf(m_hot.simulationAccumulator, tickTime);
+	}
+
+	ApplyInterpolatedView(frametime, m_hot.simulationAccumulator / tickTime);
+
+	// Look that has not gone through a tick yet is still pending
+	if (tickCount > 0)
+	{
+		OnLatencySinkWritten(EPlayerLatencySink::Rotation);
+		OnLatencySinkWritten(EPlayerLatencySink::CameraTransform);
+	}
+}
+
+void CPlayerComponent::SimulateTick(const Vec2& mouseDelta)
+{
+	PLAYER_TRACE_SCOPE("Player.SimulateTick");
+
+	m_hot.previousYaw = m_hot.currentYaw;
+	m_hot.previousPitch = m_hot.currentPitch;
+
+	// Look before movement, so the velocity of this tick uses this tick's yaw
+	m_hot.ApplyLook(mouseDelta, *m_pArchetype);
+
+	TryUpdateStance();
+	UpdateMovement();
+}
+
+void CPlayerComponent::ApplyInterpolatedView(float frametime, float alpha)
+{
+	PLAYER_TRACE_SCOPE("Player.ApplyInterpolatedView");
+
+	PLAYER_STAT_INC(SetRotation);
+	m_pEntity->SetRotation(Quat::CreateNlerp(m_hot.previousYaw, m_hot.currentYaw, alpha));
+	UpdateCamera(frametime, LERP(m_hot.previousPitch, m_hot.currentPitch, alpha));
 }
 
 void CPlayerComponent::UpdateRotation()
 {
-	m_CurrentYaw *= Quat::CreateRotationZ(m_MouseDeltaRotation.x * m_RotationSpeed);
-	m_pEntity->SetRotation(m_CurrentYaw);
+	PLAYER_TRACE_SCOPE("Player.UpdateRotation");
+
+	// Every mouse delta since the last update is applied exactly once, yaw and pitch together
+	const Vec2 mouseDelta = m_MouseDeltaAccumulator.Consume();
+	m_hot.ApplyLook(mouseDelta, *m_pArchetype);
+
+	PLAYER_STAT_INC(SetRotation);
+	m_pEntity->SetRotation(m_hot.currentYaw);
+	OnLatencySinkWritten(EPlayerLatencySink::Rotation);
 }
 
-void CPlayerComponent::UpdateCamera(float frametime)
+void CPlayerComponent::UpdateCamera(float frametime, float pitch)
 {
-	m_CurrentPitch = crymath::clamp(m_CurrentPitch + m_MouseDeltaRotation.y * m_RotationSpeed, m_RotationLimitsMaxPitch, m_RotationLimitsMinPitch);
+	PLAYER_TRACE_SCOPE("Player.UpdateCamera");
 
 	Vec3 CurrentCameraOffset = m_pCameraComponent->GetTransformMatrix().GetTranslation();
-	CurrentCameraOffset = Vec3::CreateLerp(CurrentCameraOffset,m_CameraEndOffset,10.0f*frametime);
+	CurrentCameraOffset = Vec3::CreateLerp(CurrentCameraOffset,m_hot.cameraEndOffset,10.0f*frametime);
 
 	Matrix34 finalCamMatrix;
-	finalCamMatrix.SetTranslation(m_CameraOffsetStanding);
-	finalCamMatrix.SetRotation33(Matrix33::CreateRotationX(m_CurrentPitch));
+	finalCamMatrix.SetTranslation(m_pArchetype->cameraOffsetStanding);
+	finalCamMatrix.SetRotation33(Matrix33::CreateRotationX(pitch));
+	PLAYER_STAT_INC(SetTransformMatrix);
 	m_pCameraComponent->SetTransformMatrix(finalCamMatrix);
 }
 
 void CPlayerComponent::TryUpdateStance()
 {
-	if (m_desiredPlayerStance==m_currentPlayerStance)
+	if (m_hot.desiredStance==m_hot.stance)
 		return;
 
+	PLAYER_TRACE_SCOPE("Player.TryUpdateStance");
+
 	IPhysicalEntity* pPhysEnt = m_pEntity->GetPhysicalEntity();
 
 	if (pPhysEnt == nullptr)
@@ -482,7 +1149,7 @@ void CPlayerComponent::TryUpdateStance()
 	float height = 0.f;
 	Vec3 camOffset = ZERO;
 
-	switch (m_desiredPlayerStance)
+	switch (m_hot.desiredStance)
 	{
 
 	/*case Cry::Entity::EEvent::PhysicalTypeChanged:
@@ -495,20 +1162,20 @@ void CPlayerComponent::TryUpdateStance()
 
 		case EPlayerStance::Crouching:
 		{
-			height = m_CapsuleHeightCrouching;
-			camOffset = m_CameraOffsetCrouching;
+			height = m_pArchetype->capsuleHeightCrouching;
+			camOffset = m_pArchetype->cameraOffsetCrouching;
 		} break;
 
 		case EPlayerStance::Standing:
 		{
-			height = m_CapsuleHeightStanding;
-			camOffset = m_CameraOffsetStanding;
+			height = m_pArchetype->capsuleHeightStanding;
+			camOffset = m_pArchetype->cameraOffsetStanding;
 
 			primitives::capsule capsule;
 
 			capsule.axis.Set(0, 0, 1);
 
-			capsule.center = m_pEntity->GetWorldPos() + Vec3(0, 0, m_CapsuleGroundOffset + radius + height * 0.5f);
+			capsule.center = m_pEntity->GetWorldPos() + Vec3(0, 0, m_pArchetype->capsuleGroundOffset + radius + height * 0.5f);
 			capsule.r = radius;
 			capsule.hh = height * 0.5f;
 
@@ -524,13 +1191,13 @@ void CPlayerComponent::TryUpdateStance()
 		pe_player_dimensions playerDimensions;
 		pPhysEnt->GetParams(&playerDimensions);
 
-		playerDimensions.heightCollider = m_CapsuleGroundOffset + radius + height * 0.5f;
+		playerDimensions.heightCollider = m_pArchetype->capsuleGroundOffset + radius + height * 0.5f;
 
 		playerDimensions.sizeCollider = Vec3(radius, radius, height * 0.5f);
 
-		m_CameraEndOffset = camOffset;
+		m_hot.cameraEndOffset = camOffset;
 
-		m_currentPlayerStance = m_desiredPlayerStance;
+		m_hot.stance = m_hot.desiredStance;
 
 		pPhysEnt->SetParams(&playerDimensions);
 	}
@@ -546,6 +1213,8 @@ bool CPlayerComponent::IsCapsuleIntersectingGeometry(const primitives::capsule&
 	}
 	//return false;
 
+	PLAYER_TRACE_SCOPE("Physics.StanceQuery");
+
 	IPhysicalWorld::SPWIParams pwiParams;
 	pwiParams.itype = capsule.type;
 	pwiParams.pprim = &capsule;
@@ -557,422 +1226,309 @@ bool CPlayerComponent::IsCapsuleIntersectingGeometry(const primitives::capsule&
 	intersectionParams.bSweepTest = false;
 	pwiParams.pip = &intersectionParams;
 
+	PLAYER_STAT_INC(PrimitiveIntersection);
 	const int contactCount = static_cast<int>(gEnv->pPhysicalWorld->PrimitiveWorldIntersection(pwiParams));
 
 	return contactCount > 0;
 }
 
+void CPlayerComponent::QueueFragment(TPlayerFragmentId fragmentId)
+{
+	if (fragmentId == InvalidPlayerFragmentId)
+		return;
+
+	PLAYER_TRACE_SCOPE("Mannequin.QueueFragment");
+	PLAYER_STAT_INC(QueueFragment);
+	m_pAdvancedAnimationComponent->QueueFragmentWithId(CPlayerFragmentNameTable::ToFragmentId(fragmentId));
+}
+
+void CPlayerComponent::QueueAnimation(EPlayerAnimation animation)
+{
+	if (!CPlayerFragmentNameTable::Get().IsBuilt())
+	{
+		// Without the controller definition there are no ids, the animation component looks the name up itself
+		PLAYER_STAT_INC(QueueFragment);
+		m_pAdvancedAnimationComponent->QueueFragment(this->*AnimationProperties[static_cast<size_t>(animation)]);
+		return;
+	}
+
+	QueueFragment(m_pArchetype->GetAnimation(animation));
+}
+
+_smart_ptr<CPlayerFragmentAction> CPlayerComponent::QueueFragmentAction(TPlayerFragmentId fragmentId, IPlayerFragmentListener* pListener)
+{
+	if (fragmentId == InvalidPlayerFragmentId)
+		return nullptr;
+
+	PLAYER_TRACE_SCOPE("Mannequin.QueueFragment");
+	PLAYER_STAT_INC(QueueFragment);
+
+	IActionController* pActionController = m_pAdvancedAnimationComponent ? m_pAdvancedAnimationComponent->GetActionController() : nullptr;
+	if (!pActionController)
+		return nullptr;
+
+	// Same priority the animation component queues its fragments with
+	_smart_ptr<CPlayerFragmentAction> pAction = new CPlayerFragmentAction(0, CPlayerFragmentNameTable::ToFragmentId(fragmentId), pListener);
+	pActionController->Queue(*pAction);
+	return pAction;
+}
+
 void CPlayerComponent::CheckAnimationState()
 {
 	// Check for specific animation states based on movement variables
 	if (m_Run == 1)
 	{
-		CryLogAlways("Run");
-		m_pAdvancedAnimationComponent->QueueFragment(m_AnimationRun);
+		PLAYER_LOG("Run");
+		QueueAnimation(EPlayerAnimation::Run);
 	}
 	else if (m_Crouch == 1)
 	{
 		if (m_Walk == 1 && m_Left == 1)
 		{
-			CryLogAlways("Crouch Walk Left");
-			m_pAdvancedAnimationComponent->QueueFragment(m_AnimationCrouchLeft);
+			PLAYER_LOG("Crouch Walk Left");
+			QueueAnimation(EPlayerAnimation::CrouchLeft);
 		}
 		else if (m_Walk == 1 && m_Right == 1)
 		{
-			CryLogAlways("Crouch Walk Right");
-			m_pAdvancedAnimationComponent->QueueFragment(m_AnimationCrouchRight);
+			PLAYER_LOG("Crouch Walk Right");
+			QueueAnimation(EPlayerAnimation::CrouchRight);
 		}
 		else if (m_Back == 1)
 		{
-			CryLogAlways("Crouch Walk Back");
-			m_pAdvancedAnimationComponent->QueueFragment(m_AnimationCrouchBack);
+			PLAYER_LOG("Crouch Walk Back");
+			QueueAnimation(EPlayerAnimation::CrouchBack);
 		}
 		else if (m_Walk == 1)
 		{
-			CryLogAlways("Crouch Walk");
-			m_pAdvancedAnimationComponent->QueueFragment(m_AnimationCrouchWalk);
+			PLAYER_LOG("Crouch Walk");
+			QueueAnimation(EPlayerAnimation::CrouchWalk);
 		}
 		else
 		{
-			CryLogAlways("Crouch");
-			m_pAdvancedAnimationComponent->QueueFragment(m_AnimationCrouch);
+			PLAYER_LOG("Crouch");
+			QueueAnimation(EPlayerAnimation::Crouch);
 		}
 	}
 	else if (m_Walk == 1)
 	{
 		if (m_Left == 1)
 		{
-			CryLogAlways("Walk Left");
-			m_pAdvancedAnimationComponent->QueueFragment(m_AnimationWalkLeft);
+			PLAYER_LOG("Walk Left");
+			QueueAnimation(EPlayerAnimation::WalkLeft);
 		}
 		else if (m_Right == 1)
 		{
-			CryLogAlways("Walk Right");
-			m_pAdvancedAnimationComponent->QueueFragment(m_AnimationWalkRight);
+			PLAYER_LOG("Walk Right");
+			QueueAnimation(EPlayerAnimation::WalkRight);
 		}
 		else if (m_Back == 1)
 		{
-			CryLogAlways("Walk Back");
-			m_pAdvancedAnimationComponent->QueueFragment(m_AnimationBack);
+			PLAYER_LOG("Walk Back");
+			QueueAnimation(EPlayerAnimation::Back);
 		}
 		else
 		{
-			CryLogAlways("Walk");
-			m_pAdvancedAnimationComponent->QueueFragment(m_AnimationWalk);
+			PLAYER_LOG("Walk");
+			QueueAnimation(EPlayerAnimation::Walk);
 		}
 	}
 	else if (m_Back == 1)
 	{
-		CryLogAlways("Walk Back");
-		m_pAdvancedAnimationComponent->QueueFragment(m_AnimationBack);
+		PLAYER_LOG("Walk Back");
+		QueueAnimation(EPlayerAnimation::Back);
 	}
 	else
 	{
-		CryLogAlways("Idle");
-		m_pAdvancedAnimationComponent->QueueFragment(m_AnimationIdle);
+		PLAYER_LOG("Idle");
+		QueueAnimation(EPlayerAnimation::Idle);
 	}
 }
 
-/*
-	---------------
-	FLOWGRAPH NODES
-	---------------
-*/
-
-
-
-/*
-	Input Bind Node
-*/
-
-// Static member definitions
-std::unordered_map<EKeyId, std::string> KeyMapper::s_keyIdToNameMap;
-std::unordered_map<std::string, EKeyId> KeyMapper::s_nameToKeyIdMap;
-
-void KeyMapper::InitializeKeyMappings()
-{
-	if (!s_keyIdToNameMap.empty())
-		return; // Already initialized
-
-	// Populate the mappings
-	s_keyIdToNameMap = {
-		// Keyboard keys
-		{eKI_Escape, "Escape"},
-		{eKI_1, "1"},
-		{eKI_2, "2"},
-		{eKI_3, "3"},
-		{eKI_4, "4"},
-		{eKI_5, "5"},
-		{eKI_6, "6"},
-		{eKI_7, "7"},
-		{eKI_8, "8"},
-		{eKI_9, "9"},
-		{eKI_0, "0"},
-		{eKI_Minus, "Minus"},
-		{eKI_Equals, "Equals"},
-		{eKI_Backspace, "Backspace"},
-		{eKI_Tab, "Tab"},
-		{eKI_Q, "Q"},
-		{eKI_W, "W"},
-		{eKI_E, "E"},
-		{eKI_R, "R"},
-		{eKI_T, "T"},
-		{eKI_Y, "Y"},
-		{eKI_U, "U"},
-		{eKI_I, "I"},
-		{eKI_O, "O"},
-		{eKI_P, "P"},
-		{eKI_LBracket, "LBracket"},
-		{eKI_RBracket, "RBracket"},
-		{eKI_Enter, "Enter"},
-		{eKI_LCtrl, "LCtrl"},
-		{eKI_A, "A"},
-		{eKI_S, "S"},
-		{eKI_D, "D"},
-		{eKI_F, "F"},
-		{eKI_G, "G"},
-		{eKI_H, "H"},
-		{eKI_J, "J"},
-		{eKI_K, "K"},
-		{eKI_L, "L"},
-		{eKI_Semicolon, "Semicolon"},
-		{eKI_Apostrophe, "Apostrophe"},
-		{eKI_Tilde, "Tilde"},
-		{eKI_LShift, "LShift"},
-		{eKI_Backslash, "Backslash"},
-		{eKI_Z, "Z"},
-		{eKI_X, "X"},
-		{eKI_C, "C"},
-		{eKI_V, "V"},
-		{eKI_B, "B"},
-		{eKI_N, "N"},
-		{eKI_M, "M"},
-		{eKI_Comma, "Comma"},
-		{eKI_Period, "Period"},
-		{eKI_Slash, "Slash"},
-		{eKI_RShift, "RShift"},
-		{eKI_NP_Multiply, "NPMultiply"},
-		{eKI_LAlt, "LAlt"},
-		{eKI_Space, "Space"},
-		{eKI_CapsLock, "CapsLock"},
-		{eKI_F1, "F1"},
-		{eKI_F2, "F2"},
-		{eKI_F3, "F3"},
-		{eKI_F4, "F4"},
-		{eKI_F5, "F5"},
-		{eKI_F6, "F6"},
-		{eKI_F7, "F7"},
-		{eKI_F8, "F8"},
-		{eKI_F9, "F9"},
-		{eKI_F10, "F10"},
-		{eKI_NumLock, "NumLock"},
-		{eKI_ScrollLock, "ScrollLock"},
-		{eKI_NP_7, "NP7"},
-		{eKI_NP_8, "NP8"},
-		{eKI_NP_9, "NP9"},
-		{eKI_NP_Substract, "NPSubstract"},
-		{eKI_NP_4, "NP4"},
-		{eKI_NP_5, "NP5"},
-		{eKI_NP_6, "NP6"},
-		{eKI_NP_Add, "NPAdd"},
-		{eKI_NP_1, "NP1"},
-		{eKI_NP_2, "NP2"},
-		{eKI_NP_3, "NP3"},
-		{eKI_NP_0, "NP0"},
-		{eKI_F11, "F11"},
-		{eKI_F12, "F12"},
-		{eKI_F13, "F13"},
-		{eKI_F14, "F14"},
-		{eKI_F15, "F15"},
-		{eKI_Colon, "Colon"},
-		{eKI_Underline, "Underline"},
-		{eKI_NP_Enter, "NPEnter"},
-		{eKI_RCtrl, "RCtrl"},
-		{eKI_NP_Period, "NPPeriod"},
-		{eKI_NP_Divide, "NPDivide"},
-		{eKI_Print, "Print"},
-		{eKI_RAlt, "RAlt"},
-		{eKI_Pause, "Pause"},
-		{eKI_Home, "Home"},
-		{eKI_Up, "Up"},
-		{eKI_PgUp, "PgUp"},
-		{eKI_Left, "Left"},
-		{eKI_Right, "Right"},
-		{eKI_End, "End"},
-		{eKI_Down, "Down"},
-		{eKI_PgDn, "PgDn"},
-		{eKI_Insert, "Insert"},
-		{eKI_Delete, "Delete"},
-		{eKI_LWin, "LWin"},
-		{eKI_RWin, "RWin"},
-		{eKI_Apps, "Apps"},
-		{eKI_OEM_102, "OEM102"},
-
-		// Mouse buttons
-		{eKI_Mouse1, "Mouse1"},
-		{eKI_Mouse2, "Mouse2"},
-		{eKI_Mouse3, "Mouse3"},
-		{eKI_Mouse4, "Mouse4"},
-		{eKI_Mouse5, "Mouse5"},
-		{eKI_Mouse6, "Mouse6"},
-		{eKI_Mouse7, "Mouse7"},
-		{eKI_Mouse8, "Mouse8"},
-		{eKI_MouseWheelUp, "MouseWheelUp"},
-		{eKI_MouseWheelDown, "MouseWheelDown"},
-		{eKI_MouseX, "MouseX"},
-		{eKI_MouseY, "MouseY"},
-		{eKI_MouseZ, "MouseZ"},
-		{eKI_MouseXAbsolute, "MouseXAbsolute"},
-		{eKI_MouseYAbsolute, "MouseYAbsolute"},
-
-		// Xbox controller
-		{eKI_XI_DPadUp, "XI_DPadUp"},
-		{eKI_XI_DPadDown, "XI_DPadDown"},
-		{eKI_XI_DPadLeft, "XI_DPadLeft"},
-		{eKI_XI_DPadRight, "XI_DPadRight"},
-		{eKI_XI_Start, "XI_Start"},
-		{eKI_XI_Back, "XI_Back"},
-		{eKI_XI_ThumbL, "XI_ThumbL"},
-		{eKI_XI_ThumbR, "XI_ThumbR"},
-		{eKI_XI_ShoulderL, "XI_ShoulderL"},
-		{eKI_XI_ShoulderR, "XI_ShoulderR"},
-		{eKI_XI_A, "XI_A"},
-		{eKI_XI_B, "XI_B"},
-		{eKI_XI_X, "XI_X"},
-		{eKI_XI_Y, "XI_Y"},
-		{eKI_XI_TriggerL, "XI_TriggerL"},
-		{eKI_XI_TriggerR, "XI_TriggerR"},
-		// Xbox controller
-		{ eKI_XI_DPadUp, "XI_DPadUp" },
-		{ eKI_XI_DPadDown, "XI_DPadDown" },
-		{ eKI_XI_DPadLeft, "XI_DPadLeft" },
-		{ eKI_XI_DPadRight, "XI_DPadRight" },
-		{ eKI_XI_Start, "XI_Start" },
-		{ eKI_XI_Back, "XI_Back" },
-		{ eKI_XI_ThumbL, "XI_ThumbL" },
-		{ eKI_XI_ThumbR, "XI_ThumbR" },
-		{ eKI_XI_ShoulderL, "XI_ShoulderL" },
-		{ eKI_XI_ShoulderR, "XI_ShoulderR" },
-		{ eKI_XI_A, "XI_A" },
-		{ eKI_XI_B, "XI_B" },
-		{ eKI_XI_X, "XI_X" },
-		{ eKI_XI_Y, "XI_Y" },
-		{ eKI_XI_TriggerL, "XI_TriggerL" },
-		{ eKI_XI_TriggerR, "XI_TriggerR" },
-		{ eKI_XI_ThumbLX, "XI_ThumbLX" },
-		{ eKI_XI_ThumbLY, "XI_ThumbLY" },
-		{ eKI_XI_ThumbLUp, "XI_ThumbLUp" },
-		{ eKI_XI_ThumbLDown, "XI_ThumbLDown" },
-		{ eKI_XI_ThumbLLeft, "XI_ThumbLLeft" },
-		{ eKI_XI_ThumbLRight, "XI_ThumbLRight" },
-		{ eKI_XI_ThumbRX, "XI_ThumbRX" },
-		{ eKI_XI_ThumbRY, "XI_ThumbRY" },
-		{ eKI_XI_ThumbRUp, "XI_ThumbRUp" },
-		{ eKI_XI_ThumbRDown, "XI_ThumbRDown" },
-		{ eKI_XI_ThumbRLeft, "XI_ThumbRLeft" },
-		{ eKI_XI_ThumbRRight, "XI_ThumbRRight" },
-
-		// Orbis controller
-		{ eKI_Orbis_Options, "Orbis_Options" },
-		{ eKI_Orbis_L3, "Orbis_L3" },
-		{ eKI_Orbis_R3, "Orbis_R3" },
-		{ eKI_Orbis_Up, "Orbis_Up" },
-		{ eKI_Orbis_Right, "Orbis_Right" },
-		{ eKI_Orbis_Down, "Orbis_Down" },
-		{ eKI_Orbis_Left, "Orbis_Left" },
-		{ eKI_Orbis_L2, "Orbis_L2" },  // L2 as button, for trigger use LeftTrigger.
-		{ eKI_Orbis_R2, "Orbis_R2" },  // R2 as button, for trigger use RightTrigger.
-		{ eKI_Orbis_L1, "Orbis_L1" },
-		{ eKI_Orbis_R1, "Orbis_R1" },
-		{ eKI_Orbis_Triangle, "Orbis_Triangle" },
-		{ eKI_Orbis_Circle, "Orbis_Circle" },
-		{ eKI_Orbis_Cross, "Orbis_Cross" },
-		{ eKI_Orbis_Square, "Orbis_Square" },
-		{ eKI_Orbis_StickLX, "Orbis_StickLX" },
-		{ eKI_Orbis_StickLY, "Orbis_StickLY" },
-		{ eKI_Orbis_StickRX, "Orbis_StickRX" },
-		{ eKI_Orbis_StickRY, "Orbis_StickRY" },
-		{ eKI_Orbis_RotX, "Orbis_RotX" },
-		{ eKI_Orbis_RotY, "Orbis_RotY" },
-		{ eKI_Orbis_RotZ, "Orbis_RotZ" },
-		{ eKI_Orbis_RotX_KeyL, "Orbis_RotX_KeyL" },
-		{ eKI_Orbis_RotX_KeyR, "Orbis_RotX_KeyR" },
-		{ eKI_Orbis_RotZ_KeyD, "Orbis_RotZ_KeyD" },
-		{ eKI_Orbis_RotZ_KeyU, "Orbis_RotZ_KeyU" },
-		{ eKI_Orbis_LeftTrigger, "Orbis_LeftTrigger" },  // L2 as trigger, for button use L2.
-		{ eKI_Orbis_RightTrigger, "Orbis_RightTrigger" }, // R2 as trigger, for button use R2.
-		{ eKI_Orbis_Touch, "Orbis_Touch" },
-
-		// Oculus
-		{ eKI_Motion_OculusTouch_A, "OculusTouch_A" },
-		{ eKI_Motion_OculusTouch_B, "OculusTouch_B" },
-		{ eKI_Motion_OculusTouch_X, "OculusTouch_X" },
-		{ eKI_Motion_OculusTouch_Y, "OculusTouch_Y" },
-		{ eKI_Motion_OculusTouch_L3, "OculusTouch_L3" },  // Left thumb button (stick).
-		{ eKI_Motion_OculusTouch_R3, "OculusTouch_R3" },  // Right thumb button (stick).
-		{ eKI_Motion_OculusTouch_TriggerBtnL, "OculusTouch_TriggerBtnL" },  // Left trigger button.
-		{ eKI_Motion_OculusTouch_TriggerBtnR, "OculusTouch_TriggerBtnR" },  // Right trigger button.
-		{ eKI_Motion_OculusTouch_L1, "OculusTouch_L1" },  // Left index trigger.
-		{ eKI_Motion_OculusTouch_R1, "OculusTouch_R1" },  // Right index trigger.
-		{ eKI_Motion_OculusTouch_L2, "OculusTouch_L2" },  // Left hand trigger.
-		{ eKI_Motion_OculusTouch_R2, "OculusTouch_R2" },  // Right hand trigger.
-		{ eKI_Motion_OculusTouch_StickL_Y, "OculusTouch_StickL_Y" },  // Left stick vertical motion.
-		{ eKI_Motion_OculusTouch_StickR_Y, "OculusTouch_StickR_Y" },  // Right stick vertical motion.
-		{ eKI_Motion_OculusTouch_StickL_X, "OculusTouch_StickL_X" },  // Left stick horizontal motion.
-		{ eKI_Motion_OculusTouch_StickR_X, "OculusTouch_StickR_X" },  // Right stick horizontal motion.
-		{ eKI_Motion_OculusTouch_Gesture_ThumbUpL, "OculusTouch_Gesture_ThumbUpL" },  // Gesture left thumb up.
-		{ eKI_Motion_OculusTouch_Gesture_ThumbUpR, "OculusTouch_Gesture_ThumbUpR" },  // Gesture right thumb up.
-		{ eKI_Motion_OculusTouch_Gesture_IndexPointingL, "OculusTouch_Gesture_IndexPointingL" },  // Gesture left index pointing.
-		{ eKI_Motion_OculusTouch_Gesture_IndexPointingR, "OculusTouch_Gesture_IndexPointingR" },  // Gesture right index pointing.
-
-		{ eKI_Motion_OculusTouch_NUM_SYMBOLS, "OculusTouch_NUM_SYMBOLS" },
-		{ eKI_Motion_OculusTouch_LastButtonIndex, "OculusTouch_LastButtonIndex" },
-		{ eKI_Motion_OculusTouch_FirstGestureIndex, "OculusTouch_FirstGestureIndex" },
-		{ eKI_Motion_OculusTouch_LastGestureIndex, "OculusTouch_LastGestureIndex" },
-		{ eKI_Motion_OculusTouch_FirstTriggerIndex, "OculusTouch_FirstTriggerIndex" },
-		{ eKI_Motion_OculusTouch_LastTriggerIndex, "OculusTouch_LastTriggerIndex" },
-
-		// Eye Tracker
-		{ eKI_EyeTracker_X, "EyeTracker_X" },
-		{ eKI_EyeTracker_Y, "EyeTracker_Y" },
-
-		// OpenVR
-		{ eKI_Motion_OpenVR_System, "OpenVR_System" },
-		{ eKI_Motion_OpenVR_ApplicationMenu, "OpenVR_ApplicationMenu" },
-		{ eKI_Motion_OpenVR_Grip, "OpenVR_Grip" },
-		{ eKI_Motion_OpenVR_TouchPad_X, "OpenVR_TouchPad_X" },
-		{ eKI_Motion_OpenVR_TouchPad_Y, "OpenVR_TouchPad_Y" },
-		{ eKI_Motion_OpenVR_Trigger, "OpenVR_Trigger" },
-		{ eKI_Motion_OpenVR_TriggerBtn, "OpenVR_TriggerBtn" },
-		{ eKI_Motion_OpenVR_TouchPadBtn, "OpenVR_TouchPadBtn" },
-
-		{ eKI_Motion_OpenVR_NUM_SYMBOLS, "OpenVR_NUM_SYMBOLS" }
-
-		// Add more mappings as needed...
-		// ^^ Don't trust this comment, it's all here :-) ^^
-	};
-
-	// Reverse the mapping for user-friendly name to EKeyId
-	for (const auto& pair : s_keyIdToNameMap)
+namespace
+{
+	// Payload of a shared string, identified by its characters so players sharing it count it once
+	template<typename TVisitor>
+	void VisitSharedString(TVisitor& visit, const Schematyc::CSharedString& value)
 	{
-		s_nameToKeyIdMap[pair.second] = pair.first;
+		if (!value.empty())
+		{
+			visit(EPlayerMemoryCategory::AnimationNames, value.c_str(), sizeof(string) + value.length() + 1);
+		}
 	}
 }
 
-std::string KeyMapper::KeyIdToUserFriendlyName(EKeyId keyId)
+template<typename TVisitor>
+void CPlayerComponent::VisitMemory(TVisitor&& visit) const
 {
-	InitializeKeyMappings();
+	visit(EPlayerMemoryCategory::Component, this, sizeof(*this));
+	// Allocated with new in the constructor
+	visit(EPlayerMemoryCategory::InputBuffers, m_pInputQueue.get(), sizeof(TPlayerInputQueue));
+	// The binding table belongs to the shared action map, the address dedup counts it once for all players
+	visit(EPlayerMemoryCategory::InputBuffers, &CPlayerActionMapBindings::Get(), sizeof(CPlayerActionMapBindings));
+
+	// Created by the player only to register its actions on. The [this, action] closures fit in std::function without
+	// allocating, what the input component allocates to store them is not visible from here.
+	if (m_pInputComponent)
+	{
+		visit(EPlayerMemoryCategory::InputCallbacks, m_pInputComponent, sizeof(Cry::DefaultComponents::CInputComponent));
+	}
+	if (m_pRawMouseLookListener)
+	{
+		visit(EPlayerMemoryCategory::InputCallbacks, m_pRawMouseLookListener.get(), sizeof(CRawMouseLookListener));
+	}
 
-	// Check if the keyId exists in the map
-	auto it = s_keyIdToNameMap.find(keyId);
-	if (it != s_keyIdToNameMap.end())
+	// Bucket array, then one node per entry holding the pair, the next pointer and the cached hash. The map is shared, so
+	// the addresses are the same for every player and it is only counted once.
+	if (m_pSurfaceTypes)
 	{
-		return it->second; // Return the user-friendly name
+		visit(EPlayerMemoryCategory::SurfaceTypes, m_pSurfaceTypes.get(), sizeof(TSurfaceTypeMap) + m_pSurfaceTypes->bucket_count() * sizeof(void*));
+		for (const auto& surfaceType : *m_pSurfaceTypes)
+		{
+			visit(EPlayerMemoryCategory::SurfaceTypes, &surfaceType, sizeof(surfaceType) + sizeof(void*) + sizeof(size_t));
+		}
 	}
 
-	// Fallback: Generate a user-friendly name if not found
-	// Assuming EKeyId values are enums prefixed with eKI_
-	std::string fallbackName = "Unknown";
-	if (keyId >= eKI_A && keyId <= eKI_Z) // Handle alphabetic keys
+	// Shared with every player of the same archetype
+	if (m_pArchetype)
 	{
-		fallbackName = std::string(1, 'A' + (keyId - eKI_A));
+		visit(EPlayerMemoryCategory::Archetypes, m_pArchetype.get(), sizeof(SPlayerArchetype));
 	}
-	else if (keyId >= eKI_0 && keyId <= eKI_9) // Handle numeric keys
+
+	for (const Schematyc::CSharedString* pName : {
+		&m_AnimationIdle, &m_AnimationWalk, &m_AnimationBack, &m_AnimationRun, &m_AnimationJump, &m_AnimationLeft, &m_AnimationRight,
+		&m_AnimationCrouch, &m_AnimationCrouchIdle, &m_AnimationCroucToStand, &m_AnimationStandToCrouch,
+		&m_AnimationWalkLeft, &m_AnimationWalkRight, &m_AnimationRunLeft, &m_AnimationRunRight,
+		&m_AnimationCrouchLeft, &m_AnimationCrouchRight, &m_AnimationCrouchWalk, &m_AnimationCrouchBack, &m_Tag })
 	{
-		fallbackName = std::to_string(keyId - eKI_0);
+		VisitSharedString(visit, *pName);
 	}
-	else
+}
+
+void CPlayerComponent::GetMemoryUsage(ICrySizer* pSizer) const
+{
+	for (size_t i = 0; i < CPlayerMemoryStats::CategoryCount; ++i)
 	{
-		fallbackName = "eKI_" + std::to_string(static_cast<int>(keyId));
+		const EPlayerMemoryCategory category = static_cast<EPlayerMemoryCategory>(i);
+
+		SIZER_COMPONENT_NAME(pSizer, CPlayerMemoryStats::GetCategoryName(category));
+		VisitMemory([pSizer, category](EPlayerMemoryCategory allocationCategory, const void* pAllocation, size_t bytes)
+		{
+			if (allocationCategory == category)
+			{
+				pSizer->AddObject(pAllocation, bytes);
+			}
+		});
 	}
+}
 
-	return fallbackName;
+void CPlayerComponent::AddMemoryUsage(CPlayerMemoryStats& stats) const
+{
+	VisitMemory([&stats](EPlayerMemoryCategory category, const void* pAllocation, size_t bytes)
+	{
+		stats.Add(category, pAllocation, bytes);
+	});
 }
 
-EKeyId KeyMapper::UserFriendlyNameToKeyId(const std::string& keyName)
+/*
+	---------------
+	FLOWGRAPH NODES
+	---------------
+*/
+
+
+
+namespace
 {
-	InitializeKeyMappings();
+	// The node's target entity if it has one, otherwise the local player
+	SPlayerHandle GetNodePlayerHandle(const IFlowNode::SActivationInfo* pActInfo)
+	{
+		CPlayerNodeProfileScope::CountEntityLookup();
+		CPlayerRegistry& playerRegistry = CPlayerRegistry::Get();
+		return pActInfo->pEntity ? playerRegistry.GetHandle(pActInfo->pEntity->GetId()) : playerRegistry.GetLocalPlayerHandle();
+	}
 
-	auto it = s_nameToKeyIdMap.find(keyName);
-	if (it != s_nameToKeyIdMap.end())
+	// Only looks the player up again if it was not registered when the node initialized, or has respawned since
+	CPlayerComponent* ResolveNodePlayer(SPlayerHandle& handle, const IFlowNode::SActivationInfo* pActInfo)
 	{
-		return it->second;
+		CPlayerRegistry& playerRegistry = CPlayerRegistry::Get();
+		if (CPlayerComponent* pPlayer = playerRegistry.Resolve(handle))
+			return pPlayer;
+
+		handle = GetNodePlayerHandle(pActInfo);
+		return playerRegistry.Resolve(handle);
 	}
 
-	return eKI_Unknown; // Default for unmapped keys
-}
+	// Players selected by the batch nodes, empty criteria match every player
+	struct SBatchFilter
+	{
+		EntityId groupId;    // Entity the players are attached to
+		const char* szLayer;
+		const char* szTag;   // Matched against the Player Tag property
 
+		bool Matches(const CPlayerComponent& player) const
+		{
+			if (groupId != INVALID_ENTITYID)
+			{
+				const IEntity* pParent = player.GetEntity()->GetParent();
+				if (!pParent || pParent->GetId() != groupId)
+					return false;
+			}
 
-CFlowNode_ChangeInputBinding::CFlowNode_ChangeInputBinding(SActivationInfo* pActInfo, CPlayerComponent* pPlayerComponent)
-	: m_pPlayerComponent(pPlayerComponent)
-{
-	if (!m_pPlayerComponent && pActInfo && pActInfo->pEntity)
+			if (szLayer[0])
+			{
+				CPlayerNodeProfileScope::CountEntityLookup();
+				const char* szPlayerLayer = gEnv->pEntitySystem->GetEntityLayerName(player.GetEntityId());
+				if (!szPlayerLayer || stricmp(szPlayerLayer, szLayer) != 0)
+					return false;
+			}
+
+			return !szTag[0] || stricmp(player.m_Tag.c_str(), szTag) == 0;
+		}
+	};
+
+	// Resolves the action and key names of a rebind, logs and returns false if either is unknown
+	bool ResolveBinding(const string& actionName, const string& newKey, EPlayerInputAction& action, EKeyId& keyId)
 	{
-		m_pPlayerComponent = pActInfo->pEntity->GetComponent<CPlayerComponent>();
-		CryLogAlways("[CFlowNode_ChangeInputBinding] Retrieved Player Component dynamically.");
+		if (actionName.empty())
+		{
+			PLAYER_LOG("[RebindAction] Failed: Action name is empty.");
+			return false;
+		}
+
+		if (newKey.empty())
+		{
+			PLAYER_LOG("[RebindAction] Failed: New key is empty.");
+			return false;
+		}
+
+		// Resolve the action once, the rebound callback never looks at the name again
+		action = PlayerInput::FindAction(actionName.c_str());
+		if (action == EPlayerInputAction::Count)
+		{
+			PLAYER_LOG("[RebindAction] Failed: Unknown action '%s'.", actionName.c_str());
+			return false;
+		}
+
+		// Names from INPUT-FLAGS.md resolve through the key tables, engine symbol names are still accepted
+		keyId = KeyMapper::UserFriendlyNameToKeyId(newKey.c_str());
+		if (keyId == eKI_Unknown)
+		{
+			const SInputSymbol* pInputSymbol = gEnv->pInput->GetSymbolByName(newKey.c_str());
+			if (!pInputSymbol)
+			{
+				PLAYER_LOG("[RebindAction] Failed: Key '%s' not found in input system.", newKey.c_str());
+				return false;
+			}
+			keyId = pInputSymbol->keyId;
+		}
+		return true;
 	}
 }
 
+/*
+	Input Bind Node
+*/
+
 void CFlowNode_ChangeInputBinding::GetMemoryUsage(ICrySizer* sizer) const
 {
 	sizer->AddObject(this, sizeof(*this));
@@ -984,16 +1540,20 @@ void CFlowNode_ChangeInputBinding::GetConfiguration(SFlowNodeConfig& config)
 		InputPortConfig<string>("ActionName", _HELP("Name of the action to rebind")),
 		InputPortConfig<string>("NewKey", _HELP("New key to bind to the action")),
 		InputPortConfig_Void("Trigger", _HELP("Trigger to apply the new binding")),
+		InputPortConfig<string>("Profile", _HELP("Binding profile XML with the keys of every action and device")),
+		InputPortConfig_Void("ApplyProfile", _HELP("Trigger to rebind everything listed in the profile at once")),
 		{ 0 }
 	};
 
 	static const SOutputPortConfig outputPorts[] = {
 		OutputPortConfig_Void("OnSuccess", _HELP("Triggered when the binding is successfully changed")),
 		OutputPortConfig_Void("OnFailure", _HELP("Triggered when the binding fails")),
+		OutputPortConfig<string>("OnConflict", _HELP("Triggered with the action that already uses the key when the binding fails because of it")),
 		{ 0 }
 	};
 
-	config.sDescription = _HELP("FlowGraph node to change key input bindings dynamically");
+	config.sDescription = _HELP("FlowGraph node to change key input bindings dynamically, on the target player or the local player");
+	config.nFlags |= EFLN_TARGET_ENTITY;
 	config.pInputPorts = inputPorts;
 	config.pOutputPorts = outputPorts;
 	config.SetCategory(EFLN_APPROVED);
@@ -1001,246 +1561,233 @@ void CFlowNode_ChangeInputBinding::GetConfiguration(SFlowNodeConfig& config)
 
 void CFlowNode_ChangeInputBinding::ProcessEvent(EFlowEvent event, SActivationInfo* pActInfo)
 {
-	if (event == eFE_Activate && IsPortActive(pActInfo, 2)) // Trigger input
+	switch (event)
+	{
+	case eFE_Initialize:
+	case eFE_SetEntityId:
+		m_playerHandle = GetNodePlayerHandle(pActInfo);
+		return;
+
+	case eFE_Activate:
+		break;
+
+	default:
+		return;
+	}
+
+	const bool bRebind = IsPortActive(pActInfo, 2);      // Trigger input
+	const bool bApplyProfile = IsPortActive(pActInfo, 4); // ApplyProfile input
+	if (!bRebind && !bApplyProfile)
+		return;
+
+	CPlayerNodeProfileScope profileScope(EPlayerFlowNode::ChangeInputBinding, pActInfo);
+
+	CPlayerComponent* pPlayer = ResolveNodePlayer(m_playerHandle, pActInfo);
+	if (!pPlayer || !pPlayer->m_pInputComponent)
+	{
+		PLAYER_LOG("[RebindAction] Failed: No player with an input component to rebind.");
+		profileScope.AddFailures();
+		ActivateOutput(pActInfo, 1, true); // OnFailure
+		return;
+	}
+
+	if (bRebind)
 	{
 		const string& actionName = GetPortString(pActInfo, 0);
 		const string& newKey = GetPortString(pActInfo, 1);
 
-	if (RebindAction(actionName, newKey))
+		EPlayerInputAction conflictingAction = EPlayerInputAction::Count;
+		const EPlayerBindResult result = RebindAction(*pPlayer, actionName, newKey, conflictingAction);
+		if (result == EPlayerBindResult::Bound || result == EPlayerBindResult::Unchanged)
 		{
 			ActivateOutput(pActInfo, 0, true); // OnSuccess
 		}
 		else
 		{
+			if (result == EPlayerBindResult::Conflict)
+			{
+				ActivateOutput(pActInfo, 2, string(PlayerInput::GetActionName(conflictingAction))); // OnConflict
+			}
+			profileScope.AddFailures();
 			ActivateOutput(pActInfo, 1, true); // OnFailure
 		}
 	}
-	
-}
 
-bool CFlowNode_ChangeInputBinding::RebindAction(const string& actionName, const string& newKey)
-{
-	if (!m_pPlayerComponent)
+	if (bApplyProfile)
 	{
-		CryLogAlways("[RebindAction] Player component is null. Attempting to retrieve dynamically.");
-		if (gEnv && gEnv->pEntitySystem)
+		const bool bApplied = ApplyProfile(*pPlayer, GetPortString(pActInfo, 3));
+		if (!bApplied)
 		{
-			IEntity* pEntity = gEnv->pEntitySystem->FindEntityByName("Player");
-			if (pEntity)
-			{
-				m_pPlayerComponent = pEntity->GetComponent<CPlayerComponent>();
-				if (m_pPlayerComponent)
-				{
-					CryLogAlways("[RebindAction] Successfully retrieved Player Component.");
-				}
-				else
-				{
-					CryLogAlways("[RebindAction] Failed to retrieve Player Component.");
-					return false;
-				}
-			}
-			else
-			{
-				CryLogAlways("[RebindAction] Failed: Could not find entity named 'Player'.");
-				return false;
-			}
+			profileScope.AddFailures();
 		}
+		ActivateOutput(pActInfo, bApplied ? 0 : 1, true);
 	}
+}
 
-	if (!m_pPlayerComponent)
-	{
-		CryLogAlways("[RebindAction] Failed: Player component is still null.");
-		return false;
-	}
+EPlayerBindResult CFlowNode_ChangeInputBinding::RebindAction(CPlayerComponent& player, const string& actionName, const string& newKey, EPlayerInputAction& conflictingAction)
+{
+	PLAYER_ALLOC_SCOPE("FlowNode.RebindAction");
+
+	EPlayerInputAction action;
+	EKeyId keyId;
+	if (!ResolveBinding(actionName, newKey, action, keyId))
+		return EPlayerBindResult::Failed;
 
-	if (actionName.empty())
+	// The action is already registered on the player, only its key changes
+	const EPlayerBindResult result = player.BindActionKey(action, keyId);
+	switch (result)
 	{
-		CryLogAlways("[RebindAction] Failed: Action name is empty.");
-		return false;
+	case EPlayerBindResult::Bound:
+	case EPlayerBindResult::Unchanged:
+		break;
+	case EPlayerBindResult::Conflict:
+		conflictingAction = player.GetActionBoundToKey(keyId);
+		PLAYER_LOG("[RebindAction] Failed: Key '%s' is already bound to action '%s'.", newKey.c_str(), PlayerInput::GetActionName(conflictingAction));
+		break;
+	case EPlayerBindResult::UnsupportedKey:
+		PLAYER_LOG("[RebindAction] Failed: Key '%s' is not on a supported device.", newKey.c_str());
+		break;
+	default:
+		PLAYER_LOG("[RebindAction] Failed: Could not bind action '%s' to key '%s'.", actionName.c_str(), newKey.c_str());
+		break;
 	}
+	return result;
+}
 
-	if (newKey.empty())
-	{
-		CryLogAlways("[RebindAction] Failed: New key is empty.");
+bool CFlowNode_ChangeInputBinding::ApplyProfile(CPlayerComponent& player, const string& profilePath)
+{
+	PLAYER_ALLOC_SCOPE("FlowNode.ApplyProfile");
+
+	CPlayerBindingProfile profile;
+	if (!profile.Load(profilePath.c_str(), nullptr))
 		return false;
-	}
 
-	// Retrieve the input symbol for the given key name
-	const SInputSymbol* pInputSymbol = gEnv->pInput->GetSymbolByName(newKey.c_str());
-	if (!pInputSymbol)
+	if (!player.ApplyBindingProfile(profile))
 	{
-		CryLogAlways("[RebindAction] Failed: Key '%s' not found in input system.", newKey.c_str());
+		PLAYER_LOG("[RebindAction] Failed: Could not apply binding profile '%s'.", profilePath.c_str());
 		return false;
 	}
+	return true;
+}
 
-	// Extract the EKeyId from the input symbol
-	EKeyId keyId = pInputSymbol->keyId;
 
-	// Convert the EKeyId to a user-friendly name
-	std::string keyName = KeyMapper::KeyIdToUserFriendlyName(keyId);
 
-	CryLogAlways("[RebindAction] Key '%s' resolved to EKeyId '%s'.", newKey.c_str(), keyName.c_str());
 
-	// Access the input component from the player component
-	if (m_pPlayerComponent->m_pInputComponent)
-	{
-		// Store the existing callback for the action
-		auto defaultCallback = [this, actionName](int activationMode, float value)
-			{
-				if (actionName == "moveforward")
-				{
-					m_pPlayerComponent->m_movementDelta.y = value;
-					if (activationMode == (int)eAAM_OnPress)
-					{
-						m_pPlayerComponent->m_Walk = 1;
-					}
-					else if (activationMode == eAAM_OnRelease)
-					{
-						m_pPlayerComponent->m_Walk = 0;
-					}
-				}
-				else if (actionName == "moveback")
-				{
-					m_pPlayerComponent->m_movementDelta.y = -value;
-				}
-				else if (actionName == "moveleft")
-				{
-					m_pPlayerComponent->m_movementDelta.x = -value;
-					if (activationMode == (int)eAAM_OnPress)
-					{
-						m_pPlayerComponent->m_Left = 1;
-					}
-					else if (activationMode == eAAM_OnRelease)
-					{
-						m_pPlayerComponent->m_Left = 0;
-					}
-				}
-				else if (actionName == "moveright")
-				{
-					m_pPlayerComponent->m_movementDelta.x = value;
-					if (activationMode == (int)eAAM_OnPress)
-					{
-						m_pPlayerComponent->m_Right = 1;
-					}
-					else if (activationMode == eAAM_OnRelease)
-					{
-						m_pPlayerComponent->m_Right = 0;
-					}
-				}
-				else if (actionName == "yaw")
-				{
-					m_pPlayerComponent->m_MouseDeltaRotation.y = -value;
-				}
-				else if (actionName == "pitch")
-				{
-					m_pPlayerComponent->m_MouseDeltaRotation.x = -value;
-				}
-				else if (actionName == "sprint")
-				{
-					if (activationMode == (int)eAAM_OnPress)
-					{
-						m_pPlayerComponent->m_currentPlayerState = CPlayerComponent::EPlayerState::Sprinting;
-						m_pPlayerComponent->m_Run = 1;
-					}
-					else if (activationMode == eAAM_OnRelease)
-					{
-						m_pPlayerComponent->m_currentPlayerState = CPlayerComponent::EPlayerState::Walking;
-						m_pPlayerComponent->m_Run = 0;
-					}
-				}
-				else if (actionName == "jump")
-				{
-					if (m_pPlayerComponent->m_pCharacterControllerComponent->IsOnGround())
-					{
-						m_pPlayerComponent->m_pCharacterControllerComponent->AddVelocity(Vec3(0, 0, m_pPlayerComponent->m_JumpHeight));
-					}
-				}
-				else if (actionName == "crouch")
-				{
-					if (activationMode == (int)eAAM_OnPress)
-					{
-						m_pPlayerComponent->m_desiredPlayerStance = CPlayerComponent::EPlayerStance::Crouching;
-						m_pPlayerComponent->m_Crouch = 1;
-					}
-					else if (activationMode == (int)eAAM_OnRelease)
-					{
-						m_pPlayerComponent->m_desiredPlayerStance = CPlayerComponent::EPlayerStance::Standing;
-						m_pPlayerComponent->m_Crouch = 0;
-					}
-				}
-			};
+REGISTER_FLOW_NODE("Player Component:Change Input Bind", CFlowNode_ChangeInputBinding);
 
 
-		// Create a combined callback
-		auto combinedCallback = [defaultCallback, actionName](int activationMode, float value)
-			{
-				// Call the default callback
-				defaultCallback(activationMode, value);
-
-				// Call the flowgraph node's behavior (if any)
-				CryLogAlways("[RebindAction] Flowgraph node triggered for action '%s'.", actionName.c_str());
-			};
-
-		// Register the combined callback
-		m_pPlayerComponent->m_pInputComponent->RegisterAction("player", actionName.c_str(), combinedCallback);
-
-		// Bind the action to the new key
-		m_pPlayerComponent->m_pInputComponent->BindAction(
-			"player",
-			actionName.c_str(),
-			eAID_KeyboardMouse,
-			keyId,
-			true,  // Bind on press
-			true,  // Bind on release
-			true   // Bind on hold
-		);
-
-		CryLogAlways("[RebindAction] Successfully bound action '%s' to key '%s'.", actionName.c_str(), newKey.c_str());
-		return true;
-	}
 
-	CryLogAlways("[RebindAction] Failed: Input component is null.");
-	return false;
+/*
+	Input Bind Batch Node
+*/
+
+void CFlowNode_ChangeInputBindingBatch::GetMemoryUsage(ICrySizer* sizer) const
+{
+	sizer->AddObject(this, sizeof(*this));
 }
 
+void CFlowNode_ChangeInputBindingBatch::GetConfiguration(SFlowNodeConfig& config)
+{
+	static const SInputPortConfig inputPorts[] = {
+		InputPortConfig<EntityId>("Group", INVALID_ENTITYID, _HELP("Only players attached to this entity, none for any")),
+		InputPortConfig<string>("Layer", _HELP("Only players on this layer, empty for any")),
+		InputPortConfig<string>("Tag", _HELP("Only players with this Player Tag, empty for any")),
+		InputPortConfig<string>("ActionName", _HELP("Name of the action to rebind")),
+		InputPortConfig<string>("NewKey", _HELP("New key to bind to the action")),
+		InputPortConfig_Void("Trigger", _HELP("Trigger to apply the new binding")),
+		InputPortConfig<string>("Profile", _HELP("Binding profile XML with the keys of every action and device")),
+		InputPortConfig_Void("ApplyProfile", _HELP("Trigger to rebind everything listed in the profile at once")),
+		{ 0 }
+	};
 
+	static const SOutputPortConfig outputPorts[] = {
+		OutputPortConfig<int>("Succeeded", _HELP("Number of matching players the shared action map was rebound for, pooled players take no input and are skipped")),
+		OutputPortConfig<int>("Failed", _HELP("Number of matching players the shared action map could not be rebound for")),
+		{ 0 }
+	};
 
+	config.sDescription = _HELP("FlowGraph node to change key input bindings of every matching player at once");
+	config.pInputPorts = inputPorts;
+	config.pOutputPorts = outputPorts;
+	config.SetCategory(EFLN_APPROVED);
+}
 
-REGISTER_FLOW_NODE("Player Component:Change Input Bind", CFlowNode_ChangeInputBinding);
+void CFlowNode_ChangeInputBindingBatch::ProcessEvent(EFlowEvent event, SActivationInfo* pActInfo)
+{
+	if (event != eFE_Activate)
+		return;
 
+	const bool bRebind = IsPortActive(pActInfo, 5);       // Trigger input
+	const bool bApplyProfile = IsPortActive(pActInfo, 7); // ApplyProfile input
+	if (!bRebind && !bApplyProfile)
+		return;
 
+	PLAYER_ALLOC_SCOPE("FlowNode.RebindBatch");
+	CPlayerNodeProfileScope profileScope(EPlayerFlowNode::ChangeInputBindingBatch, pActInfo);
 
-/*
-	Trigger Custom Animation Node
-*/
+	const SBatchFilter filter = { GetPortEntityId(pActInfo, 0), GetPortString(pActInfo, 1).c_str(), GetPortString(pActInfo, 2).c_str() };
 
+	// Names and the profile are resolved once for all players
+	EPlayerInputAction action = EPlayerInputAction::Count;
+	EKeyId keyId = eKI_Unknown;
+	const bool bBindingValid = bRebind && ResolveBinding(GetPortString(pActInfo, 3), GetPortString(pActInfo, 4), action, keyId);
 
-CFlowNode_TriggerCustomAnimation::CFlowNode_TriggerCustomAnimation(SActivationInfo* pActInfo)
-	: m_pPlayerComponent(nullptr)
-{
-	if (pActInfo)
+	CPlayerBindingProfile profile;
+	const bool bProfileValid = bApplyProfile && profile.Load(GetPortString(pActInfo, 6).c_str(), nullptr);
+
+	// All players bind into the one shared action map, so it is rebound once through the first matching player and
+	// the outcome holds for every matching player
+	int matchedCount = 0;
+	bool bSuccess = true;
+	for (CPlayerComponent* pPlayer : CPlayerRegistry::Get().GetPlayers())
 	{
-		if (pActInfo->pEntity)
+		// Pooled players take no input, there is nothing to rebind on them
+		if (!filter.Matches(*pPlayer) || !pPlayer->m_pInputComponent)
+			continue;
+
+		if (matchedCount++ > 0)
+			continue;
+
+		// The profile goes first so a single rebind in the same activation overrides it
+		if (bApplyProfile)
 		{
-			m_pPlayerComponent = pActInfo->pEntity->GetComponent<CPlayerComponent>();
-			if (m_pPlayerComponent)
-			{
-				CryLogAlways("[CFlowNode_TriggerCustomAnimation] Successfully retrieved Player Component.");
-			}
-			else
-			{
-				CryLogAlways("[CFlowNode_TriggerCustomAnimation] Failed to retrieve Player Component from entity.");
-			}
+			bSuccess = bProfileValid && pPlayer->ApplyBindingProfile(profile);
 		}
-		else
+		if (bSuccess && bRebind)
 		{
-			CryLogAlways("[CFlowNode_TriggerCustomAnimation] pEntity is null in Activation info.");
+			const EPlayerBindResult result = bBindingValid ? pPlayer->BindActionKey(action, keyId) : EPlayerBindResult::Failed;
+			bSuccess = result == EPlayerBindResult::Bound || result == EPlayerBindResult::Unchanged;
 		}
 	}
-	else
+
+	const int succeeded = bSuccess ? matchedCount : 0;
+	const int failed = bSuccess ? 0 : matchedCount;
+	profileScope.AddFailures(failed);
+	ActivateOutput(pActInfo, 0, succeeded);
+	ActivateOutput(pActInfo, 1, failed);
+}
+
+REGISTER_FLOW_NODE("Player Component:Change Input Bind Batch", CFlowNode_ChangeInputBindingBatch);
+
+
+
+/*
+	Trigger Custom Animation Node
+*/
+
+CFlowNode_TriggerCustomAnimation::~CFlowNode_TriggerCustomAnimation()
+{
+	ReleasePendingActions();
+}
+
+void CFlowNode_TriggerCustomAnimation::ReleasePendingActions()
+{
+	// The actions can outlive the node in the mannequin queue, they must not call back into it
+	for (const _smart_ptr<CPlayerFragmentAction>& pAction : m_pendingActions)
 	{
-		CryLogAlways("[CFlowNode_TriggerCustomAnimation] Activation info is null.");
+		pAction->SetListener(nullptr);
 	}
+	m_pendingActions.clear();
 }
 
 void CFlowNode_TriggerCustomAnimation::GetConfiguration(SFlowNodeConfig& config)
@@ -1253,12 +1800,16 @@ void CFlowNode_TriggerCustomAnimation::GetConfiguration(SFlowNodeConfig& config)
 	};
 
 	static const SOutputPortConfig outputPorts[] = {
-		OutputPortConfig_Void("OnSuccess", _HELP("Triggered when the animation is successfully played")),
+		OutputPortConfig_Void("OnSuccess", _HELP("Triggered when the animation is successfully queued")),
 		OutputPortConfig_Void("OnFailure", _HELP("Triggered if the animation fails to play")),
+		OutputPortConfig_Void("OnStarted", _HELP("Triggered when the animation starts playing")),
+		OutputPortConfig_Void("OnFinished", _HELP("Triggered when the animation played to its end")),
+		OutputPortConfig_Void("OnInterrupted", _HELP("Triggered when the animation was replaced or stopped before its end, or never started")),
 		{ 0 }
 	};
 
-	config.sDescription = _HELP("FlowGraph node to trigger a custom animation");
+	config.sDescription = _HELP("FlowGraph node to trigger a custom animation on the target player or the local player");
+	config.nFlags |= EFLN_TARGET_ENTITY;
 	config.pInputPorts = inputPorts;
 	config.pOutputPorts = outputPorts;
 	config.SetCategory(EFLN_APPROVED);
@@ -1267,81 +1818,95 @@ void CFlowNode_TriggerCustomAnimation::GetConfiguration(SFlowNodeConfig& config)
 
 void CFlowNode_TriggerCustomAnimation::ProcessEvent(EFlowEvent event, SActivationInfo* pActInfo)
 {
-	if (event == eFE_Activate && IsPortActive(pActInfo, 2)) // Trigger input
+	switch (event)
 	{
-		CryLogAlways("[CFlowNode_TriggerCustomAnimation] Trigger input activated.");
+	case eFE_Initialize:
+		// Outputs of actions queued before a restart belong to the previous run of the graph
+		ReleasePendingActions();
+		m_actInfo = *pActInfo;
+		m_playerHandle = GetNodePlayerHandle(pActInfo);
+		m_fragmentId = CPlayerFragmentNameTable::Get().Find(GetPortString(pActInfo, 0).c_str());
+		break;
+
+	case eFE_SetEntityId:
+		m_playerHandle = GetNodePlayerHandle(pActInfo);
+		break;
 
-		if (!pActInfo)
+	case eFE_Activate:
+		if (IsPortActive(pActInfo, 0)) // AnimationName input
 		{
-			CryLogAlways("[CFlowNode_TriggerCustomAnimation] Activation info is null.");
-			ActivateOutput(pActInfo, 1, true); // OnFailure
-			return;
+			m_fragmentId = CPlayerFragmentNameTable::Get().Find(GetPortString(pActInfo, 0).c_str());
 		}
-
-		if (!pActInfo->pEntity)
+		if (IsPortActive(pActInfo, 2)) // Trigger input
 		{
-			CryLogAlways("[CFlowNode_TriggerCustomAnimation] pEntity is null in Activation info. Attempting to retrieve dynamically.");
+			CPlayerNodeProfileScope profileScope(EPlayerFlowNode::TriggerCustomAnimation, pActInfo);
 
-			// Attempt to retrieve the entity dynamically by name
-			IEntity* pEntity = gEnv->pEntitySystem->FindEntityByName("Player");
-			if (pEntity)
+			CPlayerComponent* pPlayer = ResolveNodePlayer(m_playerHandle, pActInfo);
+			if (!pPlayer || !pPlayer->m_pAdvancedAnimationComponent)
 			{
-				CryLogAlways("[CFlowNode_TriggerCustomAnimation] Successfully retrieved entity dynamically.");
-				pActInfo->pEntity = pEntity; // Update pEntity in Activation info
+				PLAYER_LOG("[CFlowNode_TriggerCustomAnimation] No player with an animation component to play on.");
+				profileScope.AddFailures();
+				ActivateOutput(pActInfo, 1, true); // OnFailure
+				return;
 			}
-			else
+
+			const string& animationName = GetPortString(pActInfo, 0);
+			if (animationName.empty())
 			{
-				CryLogAlways("[CFlowNode_TriggerCustomAnimation] Failed to retrieve entity dynamically.");
+				PLAYER_LOG("[CFlowNode_TriggerCustomAnimation] Animation name is empty.");
+				profileScope.AddFailures();
 				ActivateOutput(pActInfo, 1, true); // OnFailure
 				return;
 			}
-		}
 
-		if (!m_pPlayerComponent)
-		{
-			CryLogAlways("[CFlowNode_TriggerCustomAnimation] Player component is null. Attempting to retrieve dynamically.");
-			m_pPlayerComponent = pActInfo->pEntity->GetComponent<CPlayerComponent>();
-			if (m_pPlayerComponent)
+			// The names are interned by the first player, which can spawn after the node initialized
+			if (m_fragmentId == InvalidPlayerFragmentId)
 			{
-				CryLogAlways("[CFlowNode_TriggerCustomAnimation] Successfully retrieved Player Component dynamically.");
+				m_fragmentId = CPlayerFragmentNameTable::Get().Find(animationName.c_str());
 			}
-			else
+
+			pPlayer->m_pAdvancedAnimationComponent->SetAnimationDrivenMotion(GetPortBool(pActInfo, 1));
+
+			// Without the controller definition the fragment can only be queued by name, its start and end are not reported
+			if (!CPlayerFragmentNameTable::Get().IsBuilt())
 			{
-				CryLogAlways("[CFlowNode_TriggerCustomAnimation] Failed to retrieve Player Component dynamically.");
-				ActivateOutput(pActInfo, 1, true); // OnFailure
+				pPlayer->m_pAdvancedAnimationComponent->QueueFragment(animationName.c_str());
+				ActivateOutput(pActInfo, 0, true); // OnSuccess
 				return;
 			}
-		}
 
-		if (!m_pPlayerComponent->m_pAdvancedAnimationComponent)
-		{
-			CryLogAlways("[CFlowNode_TriggerCustomAnimation] AdvancedAnimationComponent is null.");
-			ActivateOutput(pActInfo, 1, true); // OnFailure
-			return;
-		}
-
-		const string& animationName = GetPortString(pActInfo, 0);
-		const bool motionDriven = GetPortBool(pActInfo, 1);
-
-		CryLogAlways("[CFlowNode_TriggerCustomAnimation] Animation name: '%s', Motion-driven: %s",
-			animationName.c_str(), motionDriven ? "true" : "false");
+			_smart_ptr<CPlayerFragmentAction> pAction = pPlayer->QueueFragmentAction(m_fragmentId, this);
+			if (!pAction)
+			{
+				PLAYER_LOG("[CFlowNode_TriggerCustomAnimation] Fragment '%s' not found.", animationName.c_str());
+				profileScope.AddFailures();
+				ActivateOutput(pActInfo, 1, true); // OnFailure
+				return;
+			}
 
-		if (animationName.empty())
-		{
-			CryLogAlways("[CFlowNode_TriggerCustomAnimation] Animation name is empty.");
-			ActivateOutput(pActInfo, 1, true); // OnFailure
-			return;
+			// Could already have failed inside Queue
+			if (!pAction->HasEnded())
+			{
+				m_pendingActions.push_back(pAction);
+			}
+			ActivateOutput(pActInfo, 0, true); // OnSuccess
 		}
+		break;
+	}
+}
 
-		m_pPlayerComponent->m_pAdvancedAnimationComponent->SetAnimationDrivenMotion(motionDriven);
-		CryLogAlways("[CFlowNode_TriggerCustomAnimation] Motion-driven flag set to: %s", motionDriven ? "true" : "false");
+void CFlowNode_TriggerCustomAnimation::OnFragmentStarted(CPlayerFragmentAction& action)
+{
+	ActivateOutput(&m_actInfo, 2, true); // OnStarted
+}
 
-		m_pPlayerComponent->m_pAdvancedAnimationComponent->QueueFragment(Schematyc::CSharedString(animationName.c_str()));
-		CryLogAlways("[CFlowNode_TriggerCustomAnimation] Queued animation fragment: '%s'", animationName.c_str());
+void CFlowNode_TriggerCustomAnimation::OnFragmentEnded(CPlayerFragmentAction& action, bool bInterrupted)
+{
+	ActivateOutput(&m_actInfo, bInterrupted ? 4 : 3, true); // OnInterrupted or OnFinished
 
-		ActivateOutput(pActInfo, 0, true); // OnSuccess
-		CryLogAlways("[CFlowNode_TriggerCustomAnimation] Animation triggered successfully.");
-	}
+	// Ended actions hold no reference back to the node
+	action.SetListener(nullptr);
+	stl::find_and_erase_if(m_pendingActions, [&action](const _smart_ptr<CPlayerFragmentAction>& pAction) { return pAction == &action; });
 }
 
 
@@ -1349,8 +1914,99 @@ void CFlowNode_TriggerCustomAnimation::ProcessEvent(EFlowEvent event, SActivatio
 void CFlowNode_TriggerCustomAnimation::GetMemoryUsage(ICrySizer* sizer) const
 {
 	sizer->AddObject(this, sizeof(*this));
+	sizer->AddObject(m_pendingActions.data(), m_pendingActions.capacity() * sizeof(m_pendingActions[0]));
+	for (const _smart_ptr<CPlayerFragmentAction>& pAction : m_pendingActions)
+	{
+		sizer->AddObject(pAction.get(), sizeof(CPlayerFragmentAction));
+	}
 }
 
 // Register the FlowGraph node
 REGISTER_FLOW_NODE("Player Component:Play Custom Animation", CFlowNode_TriggerCustomAnimation);
 
+
+
+/*
+	Trigger Custom Animation Batch Node
+*/
+
+void CFlowNode_TriggerCustomAnimationBatch::GetConfiguration(SFlowNodeConfig& config)
+{
+	static const SInputPortConfig inputPorts[] = {
+		InputPortConfig<EntityId>("Group", INVALID_ENTITYID, _HELP("Only players attached to this entity, none for any")),
+		InputPortConfig<string>("Layer", _HELP("Only players on this layer, empty for any")),
+		InputPortConfig<string>("Tag", _HELP("Only players with this Player Tag, empty for any")),
+		InputPortConfig<string>("AnimationName", _HELP("Name of the animation fragment to trigger")),
+		InputPortConfig<bool>("MotionDriven", false, _HELP("Set to true if the animation is motion-driven")),
+		InputPortConfig_Void("Trigger", _HELP("Trigger to play the animation")),
+		{ 0 }
+	};
+
+	static const SOutputPortConfig outputPorts[] = {
+		OutputPortConfig<int>("Succeeded", _HELP("Number of matching players the animation was queued on")),
+		OutputPortConfig<int>("Failed", _HELP("Number of matching players the animation could not be queued on")),
+		{ 0 }
+	};
+
+	config.sDescription = _HELP("FlowGraph node to trigger a custom animation on every matching player at once");
+	config.pInputPorts = inputPorts;
+	config.pOutputPorts = outputPorts;
+	config.SetCategory(EFLN_APPROVED);
+}
+
+void CFlowNode_TriggerCustomAnimationBatch::ProcessEvent(EFlowEvent event, SActivationInfo* pActInfo)
+{
+	if (event != eFE_Activate || !IsPortActive(pActInfo, 5)) // Trigger input
+		return;
+
+	CPlayerNodeProfileScope profileScope(EPlayerFlowNode::TriggerCustomAnimationBatch, pActInfo);
+
+	const SBatchFilter filter = { GetPortEntityId(pActInfo, 0), GetPortString(pActInfo, 1).c_str(), GetPortString(pActInfo, 2).c_str() };
+
+	// Looked up once for every player
+	const string& animationName = GetPortString(pActInfo, 3);
+	const bool bQueueByName = !CPlayerFragmentNameTable::Get().IsBuilt() && !animationName.empty();
+	const TPlayerFragmentId fragmentId = CPlayerFragmentNameTable::Get().Find(animationName.c_str());
+	if (fragmentId == InvalidPlayerFragmentId && !bQueueByName)
+	{
+		PLAYER_LOG("[CFlowNode_TriggerCustomAnimationBatch] Fragment '%s' not found.", animationName.c_str());
+	}
+
+	const bool motionDriven = GetPortBool(pActInfo, 4);
+
+	int succeeded = 0;
+	int failed = 0;
+	for (CPlayerComponent* pPlayer : CPlayerRegistry::Get().GetPlayers())
+	{
+		if (!filter.Matches(*pPlayer))
+			continue;
+
+		if ((fragmentId == InvalidPlayerFragmentId && !bQueueByName) || !pPlayer->m_pAdvancedAnimationComponent)
+		{
+			++failed;
+			continue;
+		}
+
+		pPlayer->m_pAdvancedAnimationComponent->SetAnimationDrivenMotion(motionDriven);
+		if (bQueueByName)
+		{
+			pPlayer->m_pAdvancedAnimationComponent->QueueFragment(animationName.c_str());
+		}
+		else
+		{
+			pPlayer->QueueFragment(fragmentId);
+		}
+		++succeeded;
+	}
+
+	profileScope.AddFailures(failed);
+	ActivateOutput(pActInfo, 0, succeeded);
+	ActivateOutput(pActInfo, 1, failed);
+}
+
+void CFlowNode_TriggerCustomAnimationBatch::GetMemoryUsage(ICrySizer* sizer) const
+{
+	sizer->AddObject(this, sizeof(*this));
+}
+
+REGISTER_FLOW_NODE("Player Component:Play Custom Animation Batch", CFlowNode_TriggerCustomAnimationBatch);
@@ -16,29 +16,23 @@
 #include <CryActionCVars.h>
 #include <CryFlowGraph/IFlowBaseNode.h>
 #include <CryFlowGraph/IFlowSystem.h>
+#include <CryAudio/IAudioSystem.h>
 
 #include "StdAfx.h"
 #include "GamePlugin.h"
+#include "Components/PlayerArchetype.h"
+#include "Components/PlayerFragmentAction.h"
+#include "Components/PlayerMemoryPool.h"
+#include "Input/ActionMapBindings.h"
+#include "Input/InputEventQueue.h"
+#include "Input/KeyMapper.h"
+#include "Input/MouseDeltaAccumulator.h"
+#include "Input/PlayerInputActions.h"
+#include "Profiling/LatencyStats.h"
+#include "Profiling/MemoryStats.h"
 
 
 
-class KeyMapper
-{
-public:
-	// Converts an EKeyId to a user-friendly key name (e.g., eKI_W -> "W").
-	static std::string KeyIdToUserFriendlyName(EKeyId keyId);
-
-	// Converts a user-friendly key name to an EKeyId (e.g., "W" -> eKI_W).
-	static EKeyId UserFriendlyNameToKeyId(const std::string& keyName);
-
-private:
-	// Initializes the mapping between EKeyId and user-friendly names.
-	static void InitializeKeyMappings();
-
-	static std::unordered_map<EKeyId, std::string> s_keyIdToNameMap;
-	static std::unordered_map<std::string, EKeyId> s_nameToKeyIdMap;
-};
-
 namespace primitive
 {
 	struct capsule;
@@ -55,6 +49,9 @@ namespace Cry::DefaultComponents
 ////////////////////////////////////////////////////////
 // Represents a player participating in gameplay
 ////////////////////////////////////////////////////////
+class CPlayerBindingProfile;
+struct SPlayerInputStartState;
+
 class CPlayerComponent final : public IEntityComponent
 {
 public:
@@ -69,7 +66,7 @@ public:
 	
 
 
-	enum class EPlayerState
+	enum class EPlayerState : uint8
 	{
 		Walking,
 		Sprinting,
@@ -77,7 +74,7 @@ public:
 		Idle
 	};
 
-	enum class EPlayerStance
+	enum class EPlayerStance : uint8
 	{
 		Standing,
 		Crouching
@@ -102,19 +99,124 @@ private:
 
 	//Cry::DefaultComponents::CInputComponent* m_pInputComponent; // Declare the input component
 
+public:
+	// Runtime state the per-frame update reads and writes. Parameters are read from the
+	// shared archetype, the component properties themselves are only read by the editor.
+	struct SHotState
+	{
+		// Runtime
+		Quat currentYaw{ IDENTITY };
+		Quat previousYaw{ IDENTITY }; // Yaw and pitch of the previous fixed tick, the view is interpolated from there
+		Vec2 movementDelta{ ZERO };
+		float currentPitch = 0.f;
+		float previousPitch = 0.f;
+		float simulationAccumulator = 0.f;
+		Vec3 cameraEndOffset{ 0.f, 0.f, DEFAULT_CAMERA_HEIGHT_STANDING };
+		EPlayerState playerState = DEFAULT_PLAYER_STATE;
+		EPlayerStance stance = DEFAULT_PLAYER_STANCE;
+		EPlayerStance desiredStance = DEFAULT_PLAYER_STANCE;
+
+		// CryGetTicks() of the oldest input event each latency sink has not written yet, 0 if none
+		std::array<int64, static_cast<size_t>(EPlayerLatencySink::Count)> pendingInputTicks = {};
+
+		// Turns yaw and pitch by the mouse delta, both the variable and the fixed step update look through here
+		void ApplyLook(const Vec2& mouseDelta, const SPlayerArchetype& archetype)
+		{
+			currentYaw *= Quat::CreateRotationZ(mouseDelta.x * archetype.rotationSpeed);
+			currentPitch = crymath::clamp(currentPitch + mouseDelta.y * archetype.rotationSpeed, archetype.pitchMax, archetype.pitchMin);
+		}
+		float GetMoveSpeed(const SPlayerArchetype& archetype) const { return playerState == EPlayerState::Sprinting ? archetype.runSpeed : archetype.walkSpeed; }
+	};
+
 public:
 
 	CPlayerComponent();
-	virtual ~CPlayerComponent() override {};
+	virtual ~CPlayerComponent() override;
 
 
 	virtual void Initialize() override;
 	
 	void CheckAnimationState();
 
+	// Queues a Mannequin fragment on the advanced animation component, ids come from CPlayerFragmentNameTable
+	void QueueFragment(TPlayerFragmentId fragmentId);
+	// Queues the fragment this player's archetype names for the animation
+	void QueueAnimation(EPlayerAnimation animation);
+
+	// Queues the fragment as its own action so its start and end can be observed, null if the id is invalid
+	_smart_ptr<CPlayerFragmentAction> QueueFragmentAction(TPlayerFragmentId fragmentId, IPlayerFragmentListener* pListener);
+
+	// Applies an input action, called for live input and for replayed recordings
+	void HandleInputAction(EPlayerInputAction action, int activationMode, float value);
+
+	// Transform, look and velocity an input recording starts from
+	void CaptureInputStartState(SPlayerInputStartState& state) const;
+	void RestoreInputStartState(const SPlayerInputStartState& state);
+
+	// Entry point for bound input callbacks: records, queues or applies the action
+	void OnInputCallback(EPlayerInputAction action, int activationMode, float value);
+	// Entry point for the raw mouse listener (pl_rawMouseLook): records and accumulates the look delta
+	void OnRawLookInput(EPlayerInputAction action, float value);
+
+	// Binds an action to a key, replacing its current key on the key's device. Keys used by another action are refused.
+	// Bindings belong to the shared action map (CPlayerActionMapBindings), a rebind applies to every player.
+	EPlayerBindResult BindActionKey(EPlayerInputAction action, EKeyId keyId);
+
+	// Rebinds everything the profile lists in one pass, nothing changes if the result would bind a key twice
+	bool ApplyBindingProfile(const CPlayerBindingProfile& profile);
+
+	// EPlayerInputAction::Count if the key is free
+	EPlayerInputAction GetActionBoundToKey(EKeyId keyId) const { return CPlayerActionMapBindings::Get().GetAction(keyId); }
+	EKeyId GetKeyBoundToAction(EPlayerInputDevice device, EPlayerInputAction action) const { return CPlayerActionMapBindings::Get().GetKey(device, action); }
+
+	// Spawn pool (CPlayerSpawnPool): a pooled player is hidden, unregistered and skips its update and input
+	void ReturnToPool();
+	void ClaimFromPool(const Matrix34& worldTM);
+	bool IsPooled() const { return m_bPooled; }
+
+	// Holds a local player slot in CPlayerRegistry
+	bool IsLocalPlayer() const { return m_bLocalPlayer; }
+
+	// pl_bindingProfile change callback: loads the new profile and rebinds the player action map
+	static void OnBindingProfileChanged(ICVar* pCVar);
+
+	// Console command: rebinds an action repeatedly and checks that memory stays flat
+	static void CmdRebindStress(IConsoleCmdArgs* pArgs);
+
+	// Console command: times the look and movement update over many players, in the component layout before and after the hot/cold split
+	static void CmdUpdateBenchmark(IConsoleCmdArgs* pArgs);
+
 	virtual Cry::Entity::EventFlags GetEventMask() const override;
 	virtual void ProcessEvent(const SEntityEvent& event) override;
 
+	// Reports the component and everything it owns, the same walk feeds pl_memory
+	virtual void GetMemoryUsage(ICrySizer* pSizer) const override;
+	void AddMemoryUsage(CPlayerMemoryStats& stats) const;
+
+	// Declared first so the per-frame working set starts right after the component header
+	SHotState m_hot;
+	static_assert(sizeof(SHotState) <= 128, "The hot state should stay within two cache lines");
+
+	// The properties below as an interned block, shared with every player set up the same way. Next to the hot
+	// state, the update reads its parameters through it.
+	std::shared_ptr<const SPlayerArchetype> m_pArchetype;
+
+	// Coponent Reference
+
+	// Camera
+	Cry::DefaultComponents::CCameraComponent* m_pCameraComponent;
+
+	// Input
+	Cry::DefaultComponents::CInputComponent* m_pInputComponent;
+
+	// Physics (Character Controller)
+	Cry::DefaultComponents::CCharacterControllerComponent* m_pCharacterControllerComponent;
+
+	// Mesh&Animation (Advanced Animation Component)
+	Cry::DefaultComponents::CAdvancedAnimationComponent* m_pAdvancedAnimationComponent;
+
+
+
 	float m_movementSpeed;
 
 
@@ -137,6 +239,7 @@ public:
 		desc.AddMember(&CPlayerComponent::m_CapsuleGroundOffset, 'capo', "capsulegroundoffset", "Capsule Ground Offset", "Sets up Capsule Ground Offset", DEFAULT_CAPSULE_HEIGHT_OFFSET);
 		desc.AddMember(&CPlayerComponent::m_RotationLimitsMaxPitch, 'cpm', "camerapitchmax", "Camera Pitch Max", "Maximum Rotation Value for Camera Pitch", DEFAULT_ROT_LIMIT_PITCH_MAX);
 		desc.AddMember(&CPlayerComponent::m_RotationLimitsMinPitch, 'cpmi', "camerapitchmin", "Camera Pitch Min", "Minimum Rotation Value for Camera Pitch", DEFAULT_ROT_LIMIT_PITCH_MIN);
+		desc.AddMember(&CPlayerComponent::m_Tag, 'ptag', "playertag", "Player Tag", "Tag used by the batch flowgraph nodes to select players", Schematyc::CSharedString());
 		desc.AddMember(&CPlayerComponent::m_AnimationIdle, 'ani', "animationidle", "Idle Animation", "Set Up the Animation from Mannequin", Schematyc::CSharedString());
 		desc.AddMember(&CPlayerComponent::m_AnimationWalk, 'anw', "animationwalk", "Walk Animation", "Set Up the Animation from Mannequin", Schematyc::CSharedString());
 		desc.AddMember(&CPlayerComponent::m_AnimationIdle, 'ani', "animationidle", "Idle Animation", "Set Up the Animation from Mannequin", Schematyc::CSharedString());
@@ -162,11 +265,23 @@ public:
 	
 protected:
 	void InitializeInput();
+	void DrainInputQueue();
+
+	// Input latency measurement
+	void StampInputArrival(EPlayerInputAction action, int64 ticks);
+	void OnLatencySinkWritten(EPlayerLatencySink sink);
 	void Reset();
+	// Interns the current properties as this player's archetype
+	void ApplyArchetype();
 
 	void UpdateMovement();
 	void UpdateRotation();
-	void UpdateCamera(float frametime);
+	void UpdateCamera(float frametime, float pitch);
+
+	// Fixed timestep mode (pl_fixedStepRate > 0)
+	void UpdateFixedStep(float frametime);
+	void SimulateTick(const Vec2& mouseDelta);
+	void ApplyInterpolatedView(float frametime, float alpha);
 	void RecenterCollider();
 	
 
@@ -174,31 +289,20 @@ protected:
 	bool IsCapsuleIntersectingGeometry(const primitives::capsule& capsule) const;
 
 public:
-	// Coponent Reference
-
-	// Camera
-	Cry::DefaultComponents::CCameraComponent* m_pCameraComponent;
-
-	// Input
-	Cry::DefaultComponents::CInputComponent* m_pInputComponent;
-
-	// Physics (Character Controller)
-	Cry::DefaultComponents::CCharacterControllerComponent* m_pCharacterControllerComponent;
-
-	// Mesh&Animation (Advanced Animation Component)
-	Cry::DefaultComponents::CAdvancedAnimationComponent* m_pAdvancedAnimationComponent;
-
+	// Runtime Variable
+	// Written by the raw mouse listener, kept apart from the hot state
+	CMouseDeltaAccumulator m_MouseDeltaAccumulator;
+	// Current stick deflection, turned into look deltas every update
+	Vec2 m_lookStickDeflection{ ZERO };
+	std::unique_ptr<CRawMouseLookListener> m_pRawMouseLookListener;
 
+	// Input events pushed by the input callbacks, applied at the start of the update. The 4 KB ring is kept out of line.
+	std::unique_ptr<TPlayerInputQueue> m_pInputQueue;
 
-	// Runtime Variable
-	Quat m_CurrentYaw;
-	float m_CurrentPitch;
-	Vec2 m_movementDelta;
-	Vec2 m_MouseDeltaRotation;
-	EPlayerState m_currentPlayerState;
-	EPlayerStance m_currentPlayerStance;
-	EPlayerStance m_desiredPlayerStance;
-	Vec3 m_CameraEndOffset;
+	bool m_bInputActionsRegistered = false;
+	bool m_bPooled = false;
+	bool m_bSpawnedByPool = false;
+	bool m_bLocalPlayer = false;
 
 	// Component Properties
 	Vec3 m_CameraOffsetStanding;
@@ -212,6 +316,7 @@ public:
 	float m_CapsuleHeightStanding;
 	float m_CapsuleHeightCrouching;
 	float m_CapsuleGroundOffset;
+	Schematyc::CSharedString m_Tag;
 	
 	// Animation State
 	float m_Walk = 0;
@@ -243,12 +348,18 @@ public:
 	Schematyc::CSharedString m_AnimationCrouchBack;
 
 	private:
-		// Map to store surface types and their corresponding audio triggers
-		std::unordered_map<std::string, std::string> m_surfaceTypes;
+		typedef std::unordered_map<uint32, CryAudio::ControlId, std::hash<uint32>, std::equal_to<uint32>, CPlayerMemoryPoolAllocator<std::pair<const uint32, CryAudio::ControlId>>> TSurfaceTypeMap;
+
+		// Footstep audio triggers by lowercase CRC32 of the surface name, shared by all players
+		std::shared_ptr<const TSurfaceTypeMap> m_pSurfaceTypes;
 
 		// Private methods
 		void LoadSurfaceTypes();
 		void OnFootstepEvent(const char* eventName);
+
+		// Calls visit(EPlayerMemoryCategory, const void* pAllocation, size_t bytes) for each allocation the player owns
+		template<typename TVisitor>
+		void VisitMemory(TVisitor&& visit) const;
 };
 
 
@@ -258,27 +369,42 @@ public:
 	------------------------
 */
 
-class CFlowNode_ChangeInputBinding : public CFlowBaseNode<eNCT_Singleton>
+// Instanced, every node keeps the handle of its own target player
+class CFlowNode_ChangeInputBinding : public CFlowBaseNode<eNCT_Instanced>
 {
 public:
+	CFlowNode_ChangeInputBinding(SActivationInfo* pActInfo) {}
 
-
-	CFlowNode_ChangeInputBinding(SActivationInfo* pActInfo, CPlayerComponent* pPlayerComponent = nullptr);
-
+	virtual IFlowNodePtr Clone(SActivationInfo* pActInfo) override { return new CFlowNode_ChangeInputBinding(pActInfo); }
 	virtual void GetConfiguration(SFlowNodeConfig& config) override;
 	virtual void ProcessEvent(EFlowEvent event, SActivationInfo* pActInfo) override;
 	virtual void GetMemoryUsage(ICrySizer* sizer) const override;
 
 private:
-	bool RebindAction(const string& actionName, const string& newKey);
+	EPlayerBindResult RebindAction(CPlayerComponent& player, const string& actionName, const string& newKey, EPlayerInputAction& conflictingAction);
+	bool ApplyProfile(CPlayerComponent& player, const string& profilePath);
 
-	CPlayerComponent* m_pPlayerComponent; // Pointer to the player component
+	SPlayerHandle m_playerHandle; // Resolved on eFE_Initialize and when the target entity changes
 };
 
-class CFlowNode_TriggerCustomAnimation : public CFlowBaseNode<eNCT_Singleton>
+// Rebinds every player matching the group, layer and tag inputs in one activation
+class CFlowNode_ChangeInputBindingBatch : public CFlowBaseNode<eNCT_Singleton>
 {
 public:
-	CFlowNode_TriggerCustomAnimation(SActivationInfo* pActInfo);
+	CFlowNode_ChangeInputBindingBatch(SActivationInfo* pActInfo) {}
+
+	virtual void GetConfiguration(SFlowNodeConfig& config) override;
+	virtual void ProcessEvent(EFlowEvent event, SActivationInfo* pActInfo) override;
+	virtual void GetMemoryUsage(ICrySizer* sizer) const override;
+};
+
+class CFlowNode_TriggerCustomAnimation : public CFlowBaseNode<eNCT_Instanced>, public IPlayerFragmentListener
+{
+public:
+	CFlowNode_TriggerCustomAnimation(SActivationInfo* pActInfo) {}
+	virtual ~CFlowNode_TriggerCustomAnimation() override;
+
+	virtual IFlowNodePtr Clone(SActivationInfo* pActInfo) override { return new CFlowNode_TriggerCustomAnimation(pActInfo); }
 
 	// FlowGraph node configuration
 	virtual void GetConfiguration(SFlowNodeConfig& config) override;
@@ -289,6 +415,30 @@ public:
 	// Memory usage reporting
 	virtual void GetMemoryUsage(ICrySizer* sizer) const override;
 
+	// IPlayerFragmentListener
+	virtual void OnFragmentStarted(CPlayerFragmentAction& action) override;
+	virtual void OnFragmentEnded(CPlayerFragmentAction& action, bool bInterrupted) override;
+
 private:
-	CPlayerComponent* m_pPlayerComponent; // Reference to the player component
-};
\ No newline at end of file
+	// Detaches and forgets the queued fragments
+	void ReleasePendingActions();
+
+	SPlayerHandle m_playerHandle; // Resolved on eFE_Initialize and when the target entity changes
+	TPlayerFragmentId m_fragmentId = InvalidPlayerFragmentId; // Of the AnimationName input, looked up when it changes
+
+	// The outputs are activated from Mannequin callbacks, outside of the node's own activation
+	SActivationInfo m_actInfo;
+	// Queued fragments that have not ended, a new trigger does not cut off the outputs of the previous one
+	std::vector<_smart_ptr<CPlayerFragmentAction>, CPlayerMemoryPoolAllocator<_smart_ptr<CPlayerFragmentAction>>> m_pendingActions;
+};
+
+// Plays a fragment on every player matching the group, layer and tag inputs in one activation
+class CFlowNode_TriggerCustomAnimationBatch : public CFlowBaseNode<eNCT_Singleton>
+{
+public:
+	CFlowNode_TriggerCustomAnimationBatch(SActivationInfo* pActInfo) {}
+
+	virtual void GetConfiguration(SFlowNodeConfig& config) override;
+	virtual void ProcessEvent(EFlowEvent event, SActivationInfo* pActInfo) override;
+	virtual void GetMemoryUsage(ICrySizer* sizer) const override;
+};
@@ -0,0 +1,114 @@
+#include "StdAfx.h"
+#include "PlayerArchetype.h"
+#include "Components/PlayerMemoryPool.h"
+
+#include <functional>
+
+#include <CrySystem/IConsole.h>
+
+CPlayerArchetypeRegistry* CPlayerArchetypeRegistry::s_pThis = nullptr;
+
+namespace
+{
+	void CombineHash(size_t& hash, size_t value)
+	{
+		hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	}
+
+	void CombineHash(size_t& hash, const Vec3& value)
+	{
+		CombineHash(hash, std::hash<float>()(value.x));
+		CombineHash(hash, std::hash<float>()(value.y));
+		CombineHash(hash, std::hash<float>()(value.z));
+	}
+}
+
+bool SPlayerArchetype::operator==(const SPlayerArchetype& other) const
+{
+	if (walkSpeed != other.walkSpeed || runSpeed != other.runSpeed || jumpHeight != other.jumpHeight || rotationSpeed != other.rotationSpeed
+		|| pitchMax != other.pitchMax || pitchMin != other.pitchMin
+		|| cameraOffsetStanding != other.cameraOffsetStanding || cameraOffsetCrouching != other.cameraOffsetCrouching
+		|| capsuleHeightStanding != other.capsuleHeightStanding || capsuleHeightCrouching != other.capsuleHeightCrouching
+		|| capsuleGroundOffset != other.capsuleGroundOffset)
+	{
+		return false;
+	}
+	return animations == other.animations;
+}
+
+size_t SPlayerArchetype::GetHash() const
+{
+	size_t hash = 0;
+	for (float value : { walkSpeed, runSpeed, jumpHeight, rotationSpeed, pitchMax, pitchMin, capsuleHeightStanding, capsuleHeightCrouching, capsuleGroundOffset })
+	{
+		CombineHash(hash, std::hash<float>()(value));
+	}
+	CombineHash(hash, cameraOffsetStanding);
+	CombineHash(hash, cameraOffsetCrouching);
+	for (TPlayerFragmentId animation : animations)
+	{
+		CombineHash(hash, animation);
+	}
+	return hash;
+}
+
+std::shared_ptr<const SPlayerArchetype> CPlayerArchetypeRegistry::Intern(const SPlayerArchetype& archetype)
+{
+	const size_t hash = archetype.GetHash();
+	const auto range = m_archetypes.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		std::shared_ptr<const SPlayerArchetype> pArchetype = it->second.lock();
+		if (pArchetype && *pArchetype == archetype)
+			return pArchetype;
+	}
+
+	// Only misses can add entries, so this is the only place they need to be cleaned up
+	RemoveExpired();
+
+	std::shared_ptr<const SPlayerArchetype> pArchetype = std::allocate_shared<const SPlayerArchetype>(CPlayerMemoryPoolAllocator<SPlayerArchetype>(), archetype);
+	m_archetypes.emplace(hash, pArchetype);
+	return pArchetype;
+}
+
+size_t CPlayerArchetypeRegistry::GetArchetypeCount() const
+{
+	size_t count = 0;
+	for (const auto& archetype : m_archetypes)
+	{
+		if (!archetype.second.expired())
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+void CPlayerArchetypeRegistry::RemoveExpired()
+{
+	for (auto it = m_archetypes.begin(); it != m_archetypes.end();)
+	{
+		it = it->second.expired() ? m_archetypes.erase(it) : std::next(it);
+	}
+}
+
+void CPlayerArchetypeRegistry::Log() const
+{
+	CryLogAlways("[Archetypes] %u live archetypes, %u bytes each", static_cast<uint32>(GetArchetypeCount()), static_cast<uint32>(sizeof(SPlayerArchetype)));
+	CryLogAlways("[Archetypes] %8s %8s %8s %8s  %s", "Players", "Walk", "Run", "Jump", "Idle fragment");
+	for (const auto& archetype : m_archetypes)
+	{
+		if (std::shared_ptr<const SPlayerArchetype> pArchetype = archetype.second.lock())
+		{
+			// Minus the reference taken here
+			CryLogAlways("[Archetypes] %8ld %8.2f %8.2f %8.2f  %s", pArchetype.use_count() - 1,
+				pArchetype->walkSpeed, pArchetype->runSpeed, pArchetype->jumpHeight,
+				CPlayerFragmentNameTable::Get().GetName(pArchetype->GetAnimation(EPlayerAnimation::Idle)).c_str());
+		}
+	}
+}
+
+void CPlayerArchetypeRegistry::CmdLog(IConsoleCmdArgs* pArgs)
+{
+	Get().Log();
+}
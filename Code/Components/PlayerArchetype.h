@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include "Components/FragmentNameTable.h"
+
+struct IConsoleCmdArgs;
+
+// Mannequin fragments the player queues by itself
+enum class EPlayerAnimation : uint8
+{
+	Idle,
+	Walk,
+	Back,
+	Run,
+	Jump,
+	Left,
+	Right,
+	Crouch,
+	CrouchIdle,
+	CrouchToStand,
+	StandToCrouch,
+	WalkLeft,
+	WalkRight,
+	RunLeft,
+	RunRight,
+	CrouchLeft,
+	CrouchRight,
+	CrouchWalk,
+	CrouchBack,
+
+	Count
+};
+
+// Movement, camera, collider and animation settings of a player. Players with the
+// same properties share one interned block, which is never modified once interned.
+struct SPlayerArchetype
+{
+	static constexpr size_t AnimationCount = static_cast<size_t>(EPlayerAnimation::Count);
+
+	float walkSpeed = 0.f;
+	float runSpeed = 0.f;
+	float jumpHeight = 0.f;
+	float rotationSpeed = 0.f;
+	float pitchMax = 0.f;
+	float pitchMin = 0.f;
+	Vec3 cameraOffsetStanding{ ZERO };
+	Vec3 cameraOffsetCrouching{ ZERO };
+	float capsuleHeightStanding = 0.f;
+	float capsuleHeightCrouching = 0.f;
+	float capsuleGroundOffset = 0.f;
+	std::array<TPlayerFragmentId, AnimationCount> animations;
+
+	TPlayerFragmentId GetAnimation(EPlayerAnimation animation) const { return animations[static_cast<size_t>(animation)]; }
+
+	bool operator==(const SPlayerArchetype& other) const;
+	size_t GetHash() const;
+};
+
+////////////////////////////////////////////////////////
+// Interns player archetypes. Holds them weakly, so an
+// archetype is released with the last player using it.
+////////////////////////////////////////////////////////
+class CPlayerArchetypeRegistry
+{
+public:
+	CPlayerArchetypeRegistry()
+	{
+		s_pThis = this;
+	}
+	~CPlayerArchetypeRegistry()
+	{
+		s_pThis = nullptr;
+	}
+
+	static CPlayerArchetypeRegistry& Get()
+	{
+		CRY_ASSERT(s_pThis);
+		return *s_pThis;
+	}
+
+	// The live block equal to archetype, or a new one if no player uses it yet
+	std::shared_ptr<const SPlayerArchetype> Intern(const SPlayerArchetype& archetype);
+
+	// Archetypes still used by at least one player
+	size_t GetArchetypeCount() const;
+
+	void Log() const;
+
+	// Console command
+	static void CmdLog(IConsoleCmdArgs* pArgs);
+
+private:
+	void RemoveExpired();
+
+	std::unordered_multimap<size_t, std::weak_ptr<const SPlayerArchetype>> m_archetypes; // By hash
+
+	static CPlayerArchetypeRegistry* s_pThis;
+};
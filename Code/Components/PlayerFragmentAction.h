@@ -0,0 +1,92 @@
+#pragma once
+
+#include <ICryMannequin.h>
+
+#include "Components/PlayerMemoryPool.h"
+
+class CPlayerFragmentAction;
+
+// Receives the lifetime of a fragment queued with CPlayerComponent::QueueFragmentAction
+struct IPlayerFragmentListener
+{
+	virtual ~IPlayerFragmentListener() {}
+
+	virtual void OnFragmentStarted(CPlayerFragmentAction& action) = 0;
+	// Interrupted if the fragment was replaced, stopped or never got to play
+	virtual void OnFragmentEnded(CPlayerFragmentAction& action, bool bInterrupted) = 0;
+};
+
+////////////////////////////////////////////////////////
+// Mannequin action that plays a single fragment and
+// forwards its start and end to a listener, so callers
+// can wait for an animation without polling.
+////////////////////////////////////////////////////////
+class CPlayerFragmentAction final : public TAction<SAnimationContext>
+{
+public:
+	PLAYER_MEMORY_POOL_ALLOCATED
+
+	CPlayerFragmentAction(int priority, FragmentID fragmentId, IPlayerFragmentListener* pListener)
+		: TAction<SAnimationContext>(priority, fragmentId)
+		, m_pListener(pListener)
+	{}
+
+	// Must be cleared before the listener is destroyed, the action can outlive it inside the action controller
+	void SetListener(IPlayerFragmentListener* pListener) { m_pListener = pListener; }
+
+	bool HasEnded() const { return m_bEnded; }
+
+	virtual void Enter() override
+	{
+		TAction<SAnimationContext>::Enter();
+		m_bEntered = true;
+		if (m_pListener)
+		{
+			m_pListener->OnFragmentStarted(*this);
+		}
+	}
+
+	virtual void Exit() override
+	{
+		TAction<SAnimationContext>::Exit();
+		NotifyEnded(m_bInterrupted);
+	}
+
+	virtual void Interrupt() override
+	{
+		TAction<SAnimationContext>::Interrupt();
+		m_bInterrupted = true;
+
+		// Never entered, so there will be no Exit either
+		if (!m_bEntered)
+		{
+			NotifyEnded(true);
+		}
+	}
+
+	virtual void Fail(EActionFailure actionFailure) override
+	{
+		TAction<SAnimationContext>::Fail(actionFailure);
+		NotifyEnded(true);
+	}
+
+private:
+	void NotifyEnded(bool bInterrupted)
+	{
+		if (m_bEnded)
+			return;
+
+		m_bEnded = true;
+		if (m_pListener)
+		{
+			// The listener may drop the last outside reference
+			_smart_ptr<CPlayerFragmentAction> pKeepAlive(this);
+			m_pListener->OnFragmentEnded(*this, bInterrupted);
+		}
+	}
+
+	IPlayerFragmentListener* m_pListener;
+	bool m_bEntered = false;
+	bool m_bInterrupted = false;
+	bool m_bEnded = false;
+};
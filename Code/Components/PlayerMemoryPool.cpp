@@ -0,0 +1,238 @@
+#include "StdAfx.h"
+#include "PlayerMemoryPool.h"
+#include "Components/ConsoleVariables.h"
+
+#include <new>
+
+#include <CrySystem/IConsole.h>
+
+namespace
+{
+	// The free lists and page map are not locked. gEnv is gone when statics release their memory on shutdown.
+	bool IsMainThread()
+	{
+		return !gEnv || gEnv->mMainThreadId == CryGetCurrentThreadId();
+	}
+
+	double GetPercentage(uint64 part, uint64 total)
+	{
+		return total > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(total) : 0.0;
+	}
+}
+
+CPlayerMemoryPool& CPlayerMemoryPool::Get()
+{
+	static CPlayerMemoryPool s_instance;
+	return s_instance;
+}
+
+CPlayerMemoryPool::~CPlayerMemoryPool()
+{
+	// Pages still holding allocations at module unload are left alone, their owners may still free into them
+	for (const std::pair<const uint8* const, SPage>& page : m_pages)
+	{
+		if (page.second.liveSlots == 0)
+		{
+			CryModuleMemalignFree(const_cast<uint8*>(page.first));
+		}
+	}
+}
+
+size_t CPlayerMemoryPool::GetClassIndex(size_t size)
+{
+	size_t classIndex = 0;
+	while (classIndex < ClassCount && GetSlotSize(classIndex) < size)
+	{
+		++classIndex;
+	}
+	return classIndex;
+}
+
+CPlayerMemoryPool::SPage* CPlayerMemoryPool::FindPage(const void* pMemory)
+{
+	// Pages are page aligned, and no other allocation can start inside one of them
+	const uint8* pPage = reinterpret_cast<const uint8*>(reinterpret_cast<UINT_PTR>(pMemory) & ~static_cast<UINT_PTR>(PageSize - 1));
+	const auto it = m_pages.find(pPage);
+	return it != m_pages.end() ? &it->second : nullptr;
+}
+
+void* CPlayerMemoryPool::Allocate(size_t size)
+{
+	CRY_ASSERT(IsMainThread(), "The player memory pool is main thread only");
+	const size_t classIndex = GetClassIndex(max(size, static_cast<size_t>(1)));
+	if (classIndex < ClassCount)
+	{
+		SSizeClass& sizeClass = m_classes[classIndex];
+		if (sizeClass.pFreeList || AddPage(classIndex))
+		{
+			SFreeSlot* pSlot = sizeClass.pFreeList;
+			sizeClass.pFreeList = pSlot->pNext;
+			++FindPage(pSlot)->liveSlots;
+
+			sizeClass.peakLiveSlots = max(sizeClass.peakLiveSlots, ++sizeClass.liveSlots);
+			++m_liveAllocations;
+			m_liveRequestedBytes += size;
+			m_liveSlotBytes += GetSlotSize(classIndex);
+			m_peakSlotBytes = max(m_peakSlotBytes, m_liveSlotBytes);
+			return pSlot;
+		}
+	}
+
+	++m_fallbackAllocations;
+	++m_liveFallbacks;
+	m_liveFallbackBytes += size;
+	return ::operator new(size);
+}
+
+void CPlayerMemoryPool::Free(void* pMemory, size_t size)
+{
+	CRY_ASSERT(IsMainThread(), "The player memory pool is main thread only");
+	if (!pMemory)
+		return;
+
+	SPage* pPage = FindPage(pMemory);
+	if (!pPage)
+	{
+		--m_liveFallbacks;
+		m_liveFallbackBytes -= size;
+		::operator delete(pMemory);
+		return;
+	}
+
+	const size_t classIndex = pPage->classIndex;
+	CRY_ASSERT(GetClassIndex(max(size, static_cast<size_t>(1))) == classIndex, "Pooled memory freed with a size it cannot have been allocated with");
+
+	SSizeClass& sizeClass = m_classes[classIndex];
+	--sizeClass.liveSlots;
+	--m_liveAllocations;
+	m_liveRequestedBytes -= size;
+	m_liveSlotBytes -= GetSlotSize(classIndex);
+
+	--pPage->liveSlots;
+	if (pPage->bRetired)
+	{
+		if (pPage->liveSlots == 0)
+		{
+			ReleasePage(reinterpret_cast<uint8*>(reinterpret_cast<UINT_PTR>(pMemory) & ~static_cast<UINT_PTR>(PageSize - 1)));
+		}
+		return;
+	}
+
+	SFreeSlot* pSlot = static_cast<SFreeSlot*>(pMemory);
+	pSlot->pNext = sizeClass.pFreeList;
+	sizeClass.pFreeList = pSlot;
+}
+
+bool CPlayerMemoryPool::AddPage(size_t classIndex)
+{
+	// Pages are only taken when a size class runs out, pl_poolSize just caps them
+	const uint32 maxPages = static_cast<uint32>(static_cast<size_t>(max(CConsoleVariables::Get().pl_poolSize, 0)) * 1024 / PageSize);
+	if (m_usedPages + m_retiredPages >= maxPages)
+		return false;
+
+	uint8* pPage = static_cast<uint8*>(CryModuleMemalign(PageSize, PageSize));
+	if (!pPage)
+		return false;
+
+	m_pages.emplace(pPage, SPage{ static_cast<uint8>(classIndex), false, 0 });
+	m_peakUsedPages = max(m_peakUsedPages, ++m_usedPages);
+
+	// Thread the page's slots onto the free list in address order
+	SSizeClass& sizeClass = m_classes[classIndex];
+	const size_t slotSize = GetSlotSize(classIndex);
+	for (size_t offset = PageSize; offset >= slotSize; offset -= slotSize)
+	{
+		SFreeSlot* pSlot = reinterpret_cast<SFreeSlot*>(pPage + offset - slotSize);
+		pSlot->pNext = sizeClass.pFreeList;
+		sizeClass.pFreeList = pSlot;
+	}
+	++sizeClass.pageCount;
+	return true;
+}
+
+void CPlayerMemoryPool::ReleasePage(uint8* pPage)
+{
+	m_pages.erase(pPage);
+	CryModuleMemalignFree(pPage);
+	--m_retiredPages;
+}
+
+void CPlayerMemoryPool::Reset()
+{
+	CRY_ASSERT(IsMainThread(), "The player memory pool is main thread only");
+	++m_resetCount;
+
+	// Free slots are dropped with their lists, so the next level starts on fresh pages
+	for (SSizeClass& sizeClass : m_classes)
+	{
+		sizeClass.pFreeList = nullptr;
+		sizeClass.pageCount = 0;
+		sizeClass.peakLiveSlots = sizeClass.liveSlots;
+	}
+
+	for (auto it = m_pages.begin(); it != m_pages.end();)
+	{
+		SPage& page = it->second;
+		if (page.liveSlots == 0)
+		{
+			m_retiredPages -= page.bRetired ? 1 : 0;
+			CryModuleMemalignFree(const_cast<uint8*>(it->first));
+			it = m_pages.erase(it);
+			continue;
+		}
+
+		// Held by something that outlived the level (an archetype, a queued action), released with its last slot
+		if (!page.bRetired)
+		{
+			page.bRetired = true;
+			++m_retiredPages;
+		}
+		++it;
+	}
+
+	m_usedPages = 0;
+	m_peakUsedPages = 0;
+	m_peakSlotBytes = m_liveSlotBytes;
+}
+
+void CPlayerMemoryPool::Log() const
+{
+	uint64 freeSlotBytes = 0;
+	for (const std::pair<const uint8* const, SPage>& page : m_pages)
+	{
+		if (!page.second.bRetired)
+		{
+			freeSlotBytes += PageSize - static_cast<uint64>(page.second.liveSlots) * GetSlotSize(page.second.classIndex);
+		}
+	}
+	const uint64 usedBytes = static_cast<uint64>(m_usedPages) * PageSize;
+
+	CryLogAlways("[Pool] %u pages in use (%u KB), %u retired, peak %u pages (%u KB) this level, pl_poolSize allows %d KB",
+		m_usedPages, static_cast<uint32>(usedBytes / 1024), m_retiredPages, m_peakUsedPages, static_cast<uint32>(m_peakUsedPages * PageSize / 1024), CConsoleVariables::Get().pl_poolSize);
+	CryLogAlways("[Pool] %8s %8s %10s %10s %10s", "Slot", "Pages", "Live", "Peak live", "Free");
+	for (size_t i = 0; i < ClassCount; ++i)
+	{
+		const SSizeClass& sizeClass = m_classes[i];
+		uint32 freeSlots = 0;
+		for (const SFreeSlot* pSlot = sizeClass.pFreeList; pSlot; pSlot = pSlot->pNext)
+		{
+			++freeSlots;
+		}
+		CryLogAlways("[Pool] %8u %8u %10u %10u %10u", static_cast<uint32>(GetSlotSize(i)), sizeClass.pageCount, sizeClass.liveSlots, sizeClass.peakLiveSlots, freeSlots);
+	}
+
+	// Internal: slot bytes beyond what was asked for. External: free slots in pages already given to a size class.
+	CryLogAlways("[Pool] Live %llu allocations, %llu bytes requested in %llu bytes of slots, high-water mark %llu bytes",
+		static_cast<unsigned long long>(m_liveAllocations), static_cast<unsigned long long>(m_liveRequestedBytes),
+		static_cast<unsigned long long>(m_liveSlotBytes), static_cast<unsigned long long>(m_peakSlotBytes));
+	CryLogAlways("[Pool] Fragmentation: internal %.1f%%, external %.1f%% of the pages in use",
+		GetPercentage(m_liveSlotBytes - m_liveRequestedBytes, m_liveSlotBytes), GetPercentage(freeSlotBytes, usedBytes));
+	CryLogAlways("[Pool] Heap fallbacks: %llu total, %llu live (%llu bytes), %u resets",
+		static_cast<unsigned long long>(m_fallbackAllocations), static_cast<unsigned long long>(m_liveFallbacks),
+		static_cast<unsigned long long>(m_liveFallbackBytes), m_resetCount);
+}
+
+void CPlayerMemoryPool::CmdLog(IConsoleCmdArgs* pArgs)
+{
+	Get().Log();
+}
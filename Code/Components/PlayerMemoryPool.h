@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+
+struct IConsoleCmdArgs;
+
+////////////////////////////////////////////////////////
+// Pool the plugin's own per-player allocations come from,
+// so player churn does not fragment the general heap. Pages
+// are taken on demand up to pl_poolSize, each page cut into
+// slots of one size class. Allocations that do not fit fall
+// back to the heap. Reset on level unload. Main thread only.
+////////////////////////////////////////////////////////
+class CPlayerMemoryPool
+{
+public:
+	static constexpr size_t PageSize = 4096;
+	static constexpr size_t ClassCount = 7;
+	static constexpr size_t MinSlotSize = 16;
+	static constexpr size_t MaxSlotSize = MinSlotSize << (ClassCount - 1);
+
+	static CPlayerMemoryPool& Get();
+	~CPlayerMemoryPool();
+
+	void* Allocate(size_t size);
+	// Size must be the one the memory was allocated with
+	void Free(void* pMemory, size_t size);
+
+	// Called once the level's entities are gone. Empty pages are released and the free lists dropped,
+	// pages still holding allocations are retired and released when their last slot is freed.
+	void Reset();
+
+	void Log() const;
+
+	// Console command
+	static void CmdLog(IConsoleCmdArgs* pArgs);
+
+private:
+	struct SFreeSlot
+	{
+		SFreeSlot* pNext;
+	};
+
+	struct SSizeClass
+	{
+		SFreeSlot* pFreeList = nullptr;
+		uint32 pageCount = 0;
+		uint32 liveSlots = 0;
+		uint32 peakLiveSlots = 0;
+	};
+
+	struct SPage
+	{
+		uint8 classIndex;
+		bool bRetired;
+		uint16 liveSlots;
+	};
+
+	// ClassCount if the size is larger than the largest slot
+	static size_t GetClassIndex(size_t size);
+	static size_t GetSlotSize(size_t classIndex) { return MinSlotSize << classIndex; }
+
+	// Null if the memory is not in one of the pool's pages
+	SPage* FindPage(const void* pMemory);
+	bool AddPage(size_t classIndex);
+	void ReleasePage(uint8* pPage);
+
+	std::unordered_map<const uint8*, SPage> m_pages; // By page address
+	uint32 m_usedPages = 0; // Pages owned by a size class, retired ones not included
+	uint32 m_retiredPages = 0;
+	uint32 m_peakUsedPages = 0;
+	std::array<SSizeClass, ClassCount> m_classes;
+
+	uint64 m_liveAllocations = 0;
+	uint64 m_liveRequestedBytes = 0;
+	uint64 m_liveSlotBytes = 0;
+	uint64 m_peakSlotBytes = 0;
+
+	// Heap fallbacks, for sizes above MaxSlotSize or a pool at pl_poolSize
+	uint64 m_fallbackAllocations = 0;
+	uint64 m_liveFallbacks = 0;
+	uint64 m_liveFallbackBytes = 0;
+
+	uint32 m_resetCount = 0;
+};
+
+// Class operator new and delete taking the instances from the player memory pool
+#define PLAYER_MEMORY_POOL_ALLOCATED                                                                                           \
+	static void* operator new(size_t size) { return CPlayerMemoryPool::Get().Allocate(size); }                            \
+	static void  operator delete(void* pMemory, size_t size) { CPlayerMemoryPool::Get().Free(pMemory, size); }
+
+// Standard allocator over the player memory pool, for std::allocate_shared and containers
+template<typename T>
+class CPlayerMemoryPoolAllocator
+{
+public:
+	typedef T value_type;
+
+	CPlayerMemoryPoolAllocator() = default;
+	template<typename U>
+	CPlayerMemoryPoolAllocator(const CPlayerMemoryPoolAllocator<U>&) {}
+
+	T* allocate(size_t count) { return static_cast<T*>(CPlayerMemoryPool::Get().Allocate(count * sizeof(T))); }
+	void deallocate(T* pMemory, size_t count) { CPlayerMemoryPool::Get().Free(pMemory, count * sizeof(T)); }
+
+	template<typename U>
+	bool operator==(const CPlayerMemoryPoolAllocator<U>&) const { return true; }
+	template<typename U>
+	bool operator!=(const CPlayerMemoryPoolAllocator<U>&) const { return false; }
+};
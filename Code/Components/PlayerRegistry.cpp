@@ -0,0 +1,106 @@
+#include "StdAfx.h"
+#include "PlayerRegistry.h"
+#include "Components/Player.h"
+
+CPlayerRegistry* CPlayerRegistry::s_pThis = nullptr;
+
+void CPlayerRegistry::Register(CPlayerComponent& player)
+{
+	const EntityId entityId = player.GetEntityId();
+	if (m_entries.find(entityId) != m_entries.end())
+		return;
+
+	SEntry entry;
+	entry.index = static_cast<uint32>(m_players.size());
+	entry.localSlot = InvalidLocalSlot;
+
+	if (!m_freeHandleSlots.empty())
+	{
+		entry.handleIndex = m_freeHandleSlots.back();
+		m_freeHandleSlots.pop_back();
+		m_handleSlots[entry.handleIndex].pPlayer = &player;
+	}
+	else
+	{
+		entry.handleIndex = static_cast<uint32>(m_handleSlots.size());
+		m_handleSlots.push_back(SHandleSlot{ &player, 1 });
+	}
+
+	m_players.push_back(&player);
+	m_entries.emplace(entityId, entry);
+}
+
+void CPlayerRegistry::Unregister(CPlayerComponent& player)
+{
+	const auto it = m_entries.find(player.GetEntityId());
+	if (it == m_entries.end())
+		return;
+
+	const SEntry entry = it->second;
+	m_entries.erase(it);
+
+	if (entry.localSlot != InvalidLocalSlot)
+	{
+		m_localPlayers[entry.localSlot] = nullptr;
+	}
+
+	SHandleSlot& handleSlot = m_handleSlots[entry.handleIndex];
+	handleSlot.pPlayer = nullptr;
+	++handleSlot.generation;
+	m_freeHandleSlots.push_back(entry.handleIndex);
+
+	// Swap the last player into the freed index
+	CPlayerComponent* pLastPlayer = m_players.back();
+	m_players[entry.index] = pLastPlayer;
+	m_players.pop_back();
+	if (pLastPlayer != &player)
+	{
+		m_entries[pLastPlayer->GetEntityId()].index = entry.index;
+	}
+}
+
+uint32 CPlayerRegistry::AssignLocalSlot(CPlayerComponent& player)
+{
+	const auto it = m_entries.find(player.GetEntityId());
+	if (it == m_entries.end())
+		return InvalidLocalSlot;
+
+	SEntry& entry = it->second;
+	if (entry.localSlot != InvalidLocalSlot)
+		return entry.localSlot;
+
+	for (uint32 slot = 0; slot < MaxLocalPlayers; ++slot)
+	{
+		if (!m_localPlayers[slot])
+		{
+			m_localPlayers[slot] = &player;
+			entry.localSlot = slot;
+			break;
+		}
+	}
+	return entry.localSlot;
+}
+
+CPlayerComponent* CPlayerRegistry::FindPlayer(EntityId entityId) const
+{
+	const auto it = m_entries.find(entityId);
+	return it != m_entries.end() ? m_players[it->second.index] : nullptr;
+}
+
+SPlayerHandle CPlayerRegistry::GetHandle(EntityId entityId) const
+{
+	SPlayerHandle handle;
+	const auto it = m_entries.find(entityId);
+	if (it != m_entries.end())
+	{
+		handle.index = it->second.handleIndex;
+		handle.generation = m_handleSlots[handle.index].generation;
+	}
+	return handle;
+}
+
+SPlayerHandle CPlayerRegistry::GetLocalPlayerHandle(uint32 localSlot) const
+{
+	const CPlayerComponent* pPlayer = GetLocalPlayer(localSlot);
+	return pPlayer ? GetHandle(pPlayer->GetEntityId()) : SPlayerHandle();
+}
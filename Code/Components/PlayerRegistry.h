@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+class CPlayerComponent;
+
+// Weak reference to a registered player, goes stale once the player unregisters
+struct SPlayerHandle
+{
+	uint32 index = ~0u;  // Into the registry's handle slots
+	uint32 generation = 0;
+};
+
+////////////////////////////////////////////////////////
+// Every live CPlayerComponent, by EntityId and by local
+// player slot. Players add themselves in Initialize and
+// remove themselves on destruction. Only players driven by
+// local input take a local slot, through AssignLocalSlot.
+////////////////////////////////////////////////////////
+class CPlayerRegistry
+{
+public:
+	static constexpr uint32 MaxLocalPlayers = 4;
+	static constexpr uint32 InvalidLocalSlot = ~0u;
+
+	CPlayerRegistry()
+	{
+		s_pThis = this;
+	}
+	~CPlayerRegistry()
+	{
+		s_pThis = nullptr;
+	}
+
+	static CPlayerRegistry& Get()
+	{
+		CRY_ASSERT(s_pThis);
+		return *s_pThis;
+	}
+
+	// Players can outlive the plugin during shutdown
+	static CPlayerRegistry* GetIfAvailable() { return s_pThis; }
+
+	// Registering twice is harmless. Players are registered without a local slot.
+	void Register(CPlayerComponent& player);
+	// Also frees the player's local slot
+	void Unregister(CPlayerComponent& player);
+
+	// Gives a registered player the first free local slot, or returns the one it has.
+	// InvalidLocalSlot if the player is not registered or all local slots are taken.
+	uint32 AssignLocalSlot(CPlayerComponent& player);
+
+	CPlayerComponent* FindPlayer(EntityId entityId) const;
+	CPlayerComponent* GetLocalPlayer(uint32 localSlot = 0) const { return localSlot < MaxLocalPlayers ? m_localPlayers[localSlot] : nullptr; }
+
+	// Handles are looked up once and resolved in constant time, an empty handle if the player is not registered
+	SPlayerHandle GetHandle(EntityId entityId) const;
+	SPlayerHandle GetLocalPlayerHandle(uint32 localSlot = 0) const;
+
+	// Null if the player the handle was taken from has unregistered since
+	CPlayerComponent* Resolve(const SPlayerHandle& handle) const
+	{
+		if (handle.index >= m_handleSlots.size())
+			return nullptr;
+
+		const SHandleSlot& slot = m_handleSlots[handle.index];
+		return slot.generation == handle.generation ? slot.pPlayer : nullptr;
+	}
+
+	// Dense list of every registered player, order changes when players are removed
+	const std::vector<CPlayerComponent*>& GetPlayers() const { return m_players; }
+
+private:
+	struct SEntry
+	{
+		uint32 index;     // Into m_players
+		uint32 localSlot; // InvalidLocalSlot unless the player was assigned one
+		uint32 handleIndex;
+	};
+
+	struct SHandleSlot
+	{
+		CPlayerComponent* pPlayer;
+		uint32 generation; // Bumped when the slot is freed, so older handles stop resolving
+	};
+
+	std::vector<CPlayerComponent*> m_players;
+	std::vector<SHandleSlot> m_handleSlots;
+	std::vector<uint32> m_freeHandleSlots;
+	std::unordered_map<EntityId, SEntry> m_entries;
+	std::array<CPlayerComponent*, MaxLocalPlayers> m_localPlayers = {};
+
+	static CPlayerRegistry* s_pThis;
+};
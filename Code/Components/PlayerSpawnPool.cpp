@@ -0,0 +1,177 @@
+#include "StdAfx.h"
+#include "PlayerSpawnPool.h"
+#include "Components/ConsoleVariables.h"
+#include "Components/Player.h"
+#include "Components/PlayerRegistry.h"
+
+#include <Cry3DEngine/I3DEngine.h>
+#include <CryEntitySystem/IEntitySystem.h>
+#include <CrySystem/IConsole.h>
+#include <CrySystem/XML/IXml.h>
+
+CPlayerSpawnPool* CPlayerSpawnPool::s_pThis = nullptr;
+
+namespace
+{
+	CPlayerComponent* FindPooledPlayer(EntityId entityId)
+	{
+		IEntity* pEntity = gEnv->pEntitySystem->GetEntity(entityId);
+		return pEntity ? pEntity->GetComponent<CPlayerComponent>() : nullptr;
+	}
+}
+
+uint32 CPlayerSpawnPool::GetLevelPoolSize()
+{
+	int poolSize = CConsoleVariables::Get().pl_spawnPoolSize;
+	if (XmlNodeRef root = gEnv->pSystem->LoadXmlFromFile(gEnv->p3DEngine->GetLevelFilePath(LevelConfigFile)))
+	{
+		root->getAttr("Size", poolSize);
+	}
+	return static_cast<uint32>(max(poolSize, 0));
+}
+
+CPlayerComponent* CPlayerSpawnPool::SpawnPlayer()
+{
+	SEntitySpawnParams spawnParams;
+	spawnParams.pClass = gEnv->pEntitySystem->GetClassRegistry()->GetDefaultClass();
+	spawnParams.sName = "PooledPlayer";
+	spawnParams.nFlags |= ENTITY_FLAG_NO_SAVE;
+
+	IEntity* pEntity = gEnv->pEntitySystem->SpawnEntity(spawnParams);
+	if (!pEntity)
+		return nullptr;
+
+	// Initialize runs inside the component creation and leaves the player hidden and unregistered
+	m_bSpawning = true;
+	CPlayerComponent* pPlayer = pEntity->GetOrCreateComponent<CPlayerComponent>();
+	m_bSpawning = false;
+
+	m_owned.insert(pEntity->GetId());
+	return pPlayer;
+}
+
+void CPlayerSpawnPool::Prewarm()
+{
+	// Editor levels are saved with their entities, the pool is a game-only thing
+	if (gEnv->IsEditor())
+		return;
+
+	const uint32 poolSize = GetLevelPoolSize();
+	m_free.reserve(poolSize);
+	while (m_free.size() < poolSize)
+	{
+		CPlayerComponent* pPlayer = SpawnPlayer();
+		if (!pPlayer)
+			break;
+
+		m_free.push_back(pPlayer->GetEntityId());
+	}
+
+	if (poolSize > 0)
+	{
+		CryLogAlways("[SpawnPool] Prewarmed %u players.", static_cast<uint32>(m_free.size()));
+	}
+}
+
+void CPlayerSpawnPool::Clear()
+{
+	m_free.clear();
+	m_owned.clear();
+	m_claimedCount = 0;
+}
+
+CPlayerComponent* CPlayerSpawnPool::Claim(const Matrix34& worldTM)
+{
+	const int64 startTicks = CryGetTicks();
+
+	// Pooled entities can be removed behind the pool's back, skip those
+	CPlayerComponent* pPlayer = nullptr;
+	while (!pPlayer && !m_free.empty())
+	{
+		pPlayer = FindPooledPlayer(m_free.back());
+		m_free.pop_back();
+	}
+
+	if (!pPlayer)
+	{
+		++m_misses;
+		pPlayer = SpawnPlayer();
+		if (!pPlayer)
+			return nullptr;
+	}
+
+	pPlayer->ClaimFromPool(worldTM);
+
+	++m_claimedCount;
+	m_peakClaimed = max(m_peakClaimed, m_claimedCount);
+	m_claimTicks += CryGetTicks() - startTicks;
+	++m_claimCount;
+	return pPlayer;
+}
+
+void CPlayerSpawnPool::Return(CPlayerComponent& player)
+{
+	const EntityId entityId = player.GetEntityId();
+	if (m_owned.find(entityId) == m_owned.end())
+	{
+		gEnv->pEntitySystem->RemoveEntity(entityId);
+		return;
+	}
+
+	if (player.IsPooled())
+		return;
+
+	player.ReturnToPool();
+	m_free.push_back(entityId);
+	--m_claimedCount;
+}
+
+void CPlayerSpawnPool::Log() const
+{
+	const double averageMs = m_claimCount > 0 ? static_cast<double>(m_claimTicks) * 1000.0 / static_cast<double>(max(CryGetTicksPerSec(), static_cast<int64>(1))) / m_claimCount : 0.0;
+	CryLogAlways("[SpawnPool] %u free, %u claimed, peak %u claimed, %u claims spawned a new player, %.3f ms per claim",
+		static_cast<uint32>(m_free.size()), m_claimedCount, m_peakClaimed, m_misses, averageMs);
+}
+
+void CPlayerSpawnPool::CmdLog(IConsoleCmdArgs* pArgs)
+{
+	Get().Log();
+}
+
+void CPlayerSpawnPool::CmdClaim(IConsoleCmdArgs* pArgs)
+{
+	const int claimCount = pArgs->GetArgCount() > 1 ? max(atoi(pArgs->GetArg(1)), 1) : 1;
+
+	// In a row in front of the local player, or at the origin
+	Matrix34 worldTM(IDENTITY);
+	Vec3 step(1.f, 0.f, 0.f);
+	if (const CPlayerComponent* pLocalPlayer = CPlayerRegistry::Get().GetLocalPlayer())
+	{
+		worldTM = pLocalPlayer->GetEntity()->GetWorldTM();
+		worldTM.AddTranslation(worldTM.GetColumn1() * 2.f);
+		step = worldTM.GetColumn0();
+	}
+
+	CPlayerSpawnPool& spawnPool = Get();
+	for (int i = 0; i < claimCount; ++i)
+	{
+		if (!spawnPool.Claim(worldTM))
+			break;
+
+		worldTM.AddTranslation(step);
+	}
+	spawnPool.Log();
+}
+
+void CPlayerSpawnPool::CmdReturnAll(IConsoleCmdArgs* pArgs)
+{
+	CPlayerSpawnPool& spawnPool = Get();
+	for (const EntityId entityId : spawnPool.m_owned)
+	{
+		if (CPlayerComponent* pPlayer = FindPooledPlayer(entityId))
+		{
+			spawnPool.Return(*pPlayer);
+		}
+	}
+	spawnPool.Log();
+}
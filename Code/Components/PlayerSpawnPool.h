@@ -0,0 +1,73 @@
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+
+class CPlayerComponent;
+struct IConsoleCmdArgs;
+
+////////////////////////////////////////////////////////
+// Player entities spawned and initialized while the level
+// loads, then kept hidden and unregistered until claimed.
+// Claiming only moves, shows and registers one, returning
+// hides it again, so spawning during gameplay skips the
+// component setup, Mannequin and surface type loading.
+// Pooled players never bind input.
+////////////////////////////////////////////////////////
+class CPlayerSpawnPool
+{
+public:
+	// Per-level size, read from the level folder, pl_spawnPoolSize otherwise
+	static constexpr const char* LevelConfigFile = "PlayerSpawnPool.xml";
+
+	CPlayerSpawnPool()
+	{
+		s_pThis = this;
+	}
+	~CPlayerSpawnPool()
+	{
+		s_pThis = nullptr;
+	}
+
+	static CPlayerSpawnPool& Get()
+	{
+		CRY_ASSERT(s_pThis);
+		return *s_pThis;
+	}
+	static CPlayerSpawnPool* GetIfAvailable() { return s_pThis; }
+
+	// True while the pool creates a player, its Initialize sets it up as a pooled player
+	bool IsSpawning() const { return m_bSpawning; }
+
+	// Level load end: spawns the players of the level's pool size
+	void Prewarm();
+	// Level unload: the entity system removes the entities, the pool only forgets them
+	void Clear();
+
+	// A pooled player at worldTM, spawned on the spot if the pool ran dry
+	CPlayerComponent* Claim(const Matrix34& worldTM);
+	// Pooled players go back to the pool, any other player entity is removed
+	void Return(CPlayerComponent& player);
+
+	void Log() const;
+
+	// Console commands
+	static void CmdLog(IConsoleCmdArgs* pArgs);
+	static void CmdClaim(IConsoleCmdArgs* pArgs);
+	static void CmdReturnAll(IConsoleCmdArgs* pArgs);
+
+private:
+	static uint32 GetLevelPoolSize();
+	CPlayerComponent* SpawnPlayer();
+
+	std::vector<EntityId> m_free;
+	std::unordered_set<EntityId> m_owned; // Free and claimed
+	bool m_bSpawning = false;
+	uint32 m_claimedCount = 0; // Claimed and not returned yet
+	uint32 m_peakClaimed = 0;
+	uint32 m_misses = 0;  // Claims the pool could not serve
+	int64 m_claimTicks = 0;
+	uint32 m_claimCount = 0;
+
+	static CPlayerSpawnPool* s_pThis;
+};
@@ -1,6 +1,10 @@
 // Copyright 2016-2019 Crytek GmbH / Crytek Group. All rights reserved.
 #include "StdAfx.h"
 #include "GamePlugin.h"
+#include "Components/PlayerMemoryPool.h"
+#include "Input/BindingProfile.h"
+#include "Profiling/AllocationTracker.h"
+#include "Profiling/FrameStats.h"
 
 
 #include <CrySchematyc/Env/IEnvRegistry.h>
@@ -15,6 +19,8 @@
 
 CGamePlugin::~CGamePlugin()
 {
+	// Closes the mapped binding cache while the pak system is still alive
+	CPlayerBindingProfile::Get().Unload();
 
 	gEnv->pSystem->GetISystemEventDispatcher()->RemoveListener(this);
 
@@ -28,10 +34,22 @@ bool CGamePlugin::Initialize(SSystemGlobalEnvironment& env, const SSystemInitPar
 {
 	// Register for engine system events, in our case we need ESYSTEM_EVENT_GAME_POST_INIT to load the map
 	gEnv->pSystem->GetISystemEventDispatcher()->RegisterListener(this, "CGamePlugin");
+
+	m_consoleVariables.RegisterCVars();
+
+	// Needed to roll over the per-frame player counters
+	EnableUpdate(EUpdateStep::MainUpdate, true);
 	
 	return true;
 }
 
+void CGamePlugin::MainUpdate(float frameTime)
+{
+	CPlayerFrameStats& frameStats = CPlayerFrameStats::Get();
+	frameStats.OnFrameEnd(frameTime);
+	CPlayerAllocationTracker::Get().OnFrameEnd(frameStats.GetLastFrame(EPlayerStat::HeapAllocation));
+}
+
 void CGamePlugin::OnSystemEvent(ESystemEvent event, UINT_PTR wparam, UINT_PTR lparam)
 {
 	switch (event)
@@ -73,9 +91,22 @@ void CGamePlugin::OnSystemEvent(ESystemEvent event, UINT_PTR wparam, UINT_PTR lp
 		}
 		break;
 		
+		case ESYSTEM_EVENT_LEVEL_LOAD_END:
+		{
+			m_spawnPool.Prewarm();
+		}
+		break;
+
 		case ESYSTEM_EVENT_LEVEL_UNLOAD:
 		{
-		
+			m_spawnPool.Clear();
+		}
+		break;
+
+		case ESYSTEM_EVENT_LEVEL_POST_UNLOAD:
+		{
+			// The level's players are gone, whatever still holds pool memory keeps only its own pages
+			CPlayerMemoryPool::Get().Reset();
 		}
 		break;
 	}
@@ -4,6 +4,12 @@
 #include <CrySystem/ICryPlugin.h>
 #include <CryEntitySystem/IEntityClass.h>
 
+#include "Components/ConsoleVariables.h"
+#include "Components/FragmentNameTable.h"
+#include "Components/PlayerArchetype.h"
+#include "Components/PlayerRegistry.h"
+#include "Components/PlayerSpawnPool.h"
+
 
 // The entry-point of the application
 // An instance of CGamePlugin is automatically created when the library is loaded
@@ -21,6 +27,7 @@ public:
 	// Cry::IEnginePlugin
 	virtual const char* GetCategory() const override { return "Game"; }
 	virtual bool Initialize(SSystemGlobalEnvironment& env, const SSystemInitParams& initParams) override;
+	virtual void MainUpdate(float frameTime) override;
 	// ~Cry::IEnginePlugin
 
 	// ISystemEventListener
@@ -36,4 +43,9 @@ public:
 	PLUGIN_FLOWNODE_UNREGISTER
 
 protected:
+	CConsoleVariables m_consoleVariables;
+	CPlayerRegistry m_playerRegistry;
+	CPlayerFragmentNameTable m_fragmentNameTable;
+	CPlayerArchetypeRegistry m_archetypeRegistry;
+	CPlayerSpawnPool m_spawnPool;
 };
\ No newline at end of file
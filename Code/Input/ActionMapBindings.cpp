@@ -0,0 +1,99 @@
+#include "StdAfx.h"
+#include "ActionMapBindings.h"
+#include "Input/BindingProfile.h"
+#include "Input/KeyMapper.h"
+#include "Profiling/FrameStats.h"
+
+#include <CryGame/IGameFramework.h>
+#include <DefaultComponents/Input/InputComponent.h>
+
+CPlayerActionMapBindings& CPlayerActionMapBindings::Get()
+{
+	static CPlayerActionMapBindings s_instance;
+	return s_instance;
+}
+
+EPlayerBindResult CPlayerActionMapBindings::BindActionKey(Cry::DefaultComponents::CInputComponent& inputComponent, EPlayerInputAction action, EKeyId keyId)
+{
+	if (action >= EPlayerInputAction::Count || !CPlayerBindingTable::IsBindable(keyId))
+		return EPlayerBindResult::UnsupportedKey;
+
+	const EPlayerInputDevice device = PlayerInput::GetKeyDevice(keyId);
+	const EKeyId boundKeyId = m_table.GetKey(device, action);
+	if (boundKeyId == keyId)
+		return EPlayerBindResult::Unchanged;
+
+	if (m_table.GetAction(keyId) != EPlayerInputAction::Count)
+		return EPlayerBindResult::Conflict;
+
+	if (!ApplyActionKey(inputComponent, action, device, boundKeyId, keyId))
+		return EPlayerBindResult::Failed;
+
+	m_table.SetKey(action, keyId);
+	m_bEmpty = false;
+	return EPlayerBindResult::Bound;
+}
+
+bool CPlayerActionMapBindings::ApplyProfile(Cry::DefaultComponents::CInputComponent& inputComponent, const CPlayerBindingProfile& profile)
+{
+	// Build the final table first, keys may move between actions as long as no two actions end up sharing one
+	CPlayerBindingTable targetTable = m_table;
+	const CPlayerBindingProfile::SBinding* pBindings = profile.GetBindings();
+	for (uint32 i = 0, count = profile.GetBindingCount(); i < count; ++i)
+	{
+		targetTable.SetKey(static_cast<EPlayerInputAction>(pBindings[i].action), static_cast<EKeyId>(pBindings[i].keyId));
+	}
+
+	EKeyId conflictKeyId;
+	EPlayerInputAction action, otherAction;
+	if (targetTable.FindConflict(conflictKeyId, action, otherAction))
+	{
+		const std::string_view keyName = KeyMapper::KeyIdToUserFriendlyName(conflictKeyId);
+		PLAYER_LOG("[Bindings] Key '%.*s' would be bound to both '%s' and '%s'.", static_cast<int>(keyName.size()), keyName.data(),
+			PlayerInput::GetActionName(action), PlayerInput::GetActionName(otherAction));
+		return false;
+	}
+
+	bool bSucceeded = true;
+	for (size_t device = 0; device < PlayerInput::DeviceCount; ++device)
+	{
+		for (size_t i = 0; i < PlayerInput::ActionCount; ++i)
+		{
+			const EPlayerInputDevice inputDevice = static_cast<EPlayerInputDevice>(device);
+			const EPlayerInputAction inputAction = static_cast<EPlayerInputAction>(i);
+			const EKeyId boundKeyId = m_table.GetKey(inputDevice, inputAction);
+			const EKeyId keyId = targetTable.GetKey(inputDevice, inputAction);
+			if (keyId == boundKeyId)
+				continue;
+
+			if (ApplyActionKey(inputComponent, inputAction, inputDevice, boundKeyId, keyId))
+			{
+				m_table.SetKey(inputAction, keyId);
+				m_bEmpty = false;
+			}
+			else
+			{
+				const std::string_view keyName = KeyMapper::KeyIdToUserFriendlyName(keyId);
+				PLAYER_LOG("[Bindings] Failed to bind '%s' to key '%.*s'.", PlayerInput::GetActionName(inputAction), static_cast<int>(keyName.size()), keyName.data());
+				bSucceeded = false;
+			}
+		}
+	}
+	return bSucceeded;
+}
+
+bool CPlayerActionMapBindings::ApplyActionKey(Cry::DefaultComponents::CInputComponent& inputComponent, EPlayerInputAction action, EPlayerInputDevice device, EKeyId boundKeyId, EKeyId keyId)
+{
+	const char* szActionName = PlayerInput::GetActionName(action);
+
+	if (boundKeyId == eKI_Unknown)
+	{
+		inputComponent.BindAction(PlayerInput::ActionGroup, szActionName, PlayerInput::GetActionInputDevice(device), keyId);
+		return true;
+	}
+
+	// Replace the existing input instead of stacking another one on the action. The table is the map's own, so the
+	// old key is the one the map holds no matter which player bound it.
+	IActionMap* pActionMap = gEnv->pGameFramework->GetIActionMapManager()->GetActionMap(PlayerInput::ActionGroup);
+	return pActionMap && pActionMap->ReBindActionInput(ActionId(szActionName), gEnv->pInput->GetKeyName(boundKeyId), gEnv->pInput->GetKeyName(keyId));
+}
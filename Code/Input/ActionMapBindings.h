@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Input/BindingTable.h"
+
+class CPlayerBindingProfile;
+
+namespace Cry
+{
+	namespace DefaultComponents
+	{
+		class CInputComponent;
+	}
+}
+
+////////////////////////////////////////////////////////
+// The keys bound on the player action map. Every player's
+// input component registers its actions in the same map,
+// so a binding belongs to the map and is kept once for
+// all players. The map outlives the players, so does the
+// table.
+////////////////////////////////////////////////////////
+class CPlayerActionMapBindings
+{
+public:
+	static CPlayerActionMapBindings& Get();
+
+	// Nothing bound yet, the first player to register its actions applies the profile
+	bool IsEmpty() const { return m_bEmpty; }
+
+	// Binds an action to a key, replacing its current key on the key's device. Keys used by another action are refused.
+	// The input component adds the first key of an action to the map, later keys replace it there.
+	EPlayerBindResult BindActionKey(Cry::DefaultComponents::CInputComponent& inputComponent, EPlayerInputAction action, EKeyId keyId);
+
+	// Rebinds everything the profile lists in one pass, nothing changes if the result would bind a key twice
+	bool ApplyProfile(Cry::DefaultComponents::CInputComponent& inputComponent, const CPlayerBindingProfile& profile);
+
+	// EPlayerInputAction::Count if the key is free
+	EPlayerInputAction GetAction(EKeyId keyId) const { return m_table.GetAction(keyId); }
+	EKeyId GetKey(EPlayerInputDevice device, EPlayerInputAction action) const { return m_table.GetKey(device, action); }
+
+private:
+	bool ApplyActionKey(Cry::DefaultComponents::CInputComponent& inputComponent, EPlayerInputAction action, EPlayerInputDevice device, EKeyId boundKeyId, EKeyId keyId);
+
+	// Only follows bindings the action map accepted
+	CPlayerBindingTable m_table;
+	bool m_bEmpty = true;
+};
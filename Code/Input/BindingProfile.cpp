@@ -0,0 +1,265 @@
+#include "StdAfx.h"
+#include "BindingProfile.h"
+#include "Input/KeyMapper.h"
+
+#include <CryCore/CryCrc32.h>
+#include <CrySystem/File/ICryPak.h>
+#include <CrySystem/XML/IXml.h>
+
+namespace
+{
+	struct SDefaultBinding
+	{
+		EPlayerInputAction action;
+		EKeyId keyId;
+	};
+
+	// Used when no binding profile can be loaded
+	static constexpr SDefaultBinding s_defaultBindings[] =
+	{
+		// Keyboard and mouse
+		{ EPlayerInputAction::MoveForward, eKI_W },
+		{ EPlayerInputAction::MoveBack, eKI_S },
+		{ EPlayerInputAction::MoveLeft, eKI_A },
+		{ EPlayerInputAction::MoveRight, eKI_D },
+		{ EPlayerInputAction::Yaw, eKI_MouseY },
+		{ EPlayerInputAction::Pitch, eKI_MouseX },
+		{ EPlayerInputAction::Sprint, eKI_LShift },
+		{ EPlayerInputAction::Jump, eKI_Space },
+		{ EPlayerInputAction::Crouch, eKI_C },
+
+		// Xbox controller
+		{ EPlayerInputAction::MoveForward, eKI_XI_ThumbLUp },
+		{ EPlayerInputAction::MoveBack, eKI_XI_ThumbLDown },
+		{ EPlayerInputAction::MoveLeft, eKI_XI_ThumbLLeft },
+		{ EPlayerInputAction::MoveRight, eKI_XI_ThumbLRight },
+		{ EPlayerInputAction::YawStick, eKI_XI_ThumbRY },
+		{ EPlayerInputAction::PitchStick, eKI_XI_ThumbRX },
+		{ EPlayerInputAction::Sprint, eKI_XI_ThumbL },
+		{ EPlayerInputAction::Jump, eKI_XI_A },
+		{ EPlayerInputAction::Crouch, eKI_XI_B },
+
+		// Orbis controller
+		{ EPlayerInputAction::MoveForward, eKI_Orbis_Up },
+		{ EPlayerInputAction::MoveBack, eKI_Orbis_Down },
+		{ EPlayerInputAction::MoveLeft, eKI_Orbis_Left },
+		{ EPlayerInputAction::MoveRight, eKI_Orbis_Right },
+		{ EPlayerInputAction::YawStick, eKI_Orbis_StickRY },
+		{ EPlayerInputAction::PitchStick, eKI_Orbis_StickRX },
+		{ EPlayerInputAction::Sprint, eKI_Orbis_L3 },
+		{ EPlayerInputAction::Jump, eKI_Orbis_Cross },
+		{ EPlayerInputAction::Crouch, eKI_Orbis_Circle },
+
+		// Oculus, the left stick axes carry both directions
+		{ EPlayerInputAction::MoveForward, eKI_Motion_OculusTouch_StickL_Y },
+		{ EPlayerInputAction::MoveRight, eKI_Motion_OculusTouch_StickL_X },
+		{ EPlayerInputAction::YawStick, eKI_Motion_OculusTouch_StickR_Y },
+		{ EPlayerInputAction::PitchStick, eKI_Motion_OculusTouch_StickR_X },
+		{ EPlayerInputAction::Sprint, eKI_Motion_OculusTouch_L3 },
+		{ EPlayerInputAction::Jump, eKI_Motion_OculusTouch_A },
+		{ EPlayerInputAction::Crouch, eKI_Motion_OculusTouch_B }
+	};
+}
+
+CPlayerBindingProfile& CPlayerBindingProfile::Get()
+{
+	static CPlayerBindingProfile s_instance;
+	return s_instance;
+}
+
+CPlayerBindingProfile::~CPlayerBindingProfile()
+{
+	Unload();
+}
+
+bool CPlayerBindingProfile::Load(const char* szProfilePath, const char* szCachePath)
+{
+	Unload();
+
+	// Only the modification time is needed to validate the cache, the XML is not parsed unless it changed
+	uint64 sourceModificationTime = 0;
+	if (FILE* pProfileFile = gEnv->pCryPak->FOpen(szProfilePath, "rb"))
+	{
+		sourceModificationTime = gEnv->pCryPak->GetModificationTime(pProfileFile);
+		gEnv->pCryPak->FClose(pProfileFile);
+	}
+	else
+	{
+		CryLogAlways("[BindingProfile] '%s' not found, using the built-in bindings.", szProfilePath);
+		CompileDefaults();
+		return false;
+	}
+
+	// The cache is shared by every profile pl_bindingProfile may point to, it is only valid for the one it was compiled from
+	const uint32 sourcePathCrc = CCrc32::ComputeLowercase(szProfilePath);
+	if (szCachePath && MapCache(szCachePath, sourcePathCrc, sourceModificationTime))
+		return true;
+
+	if (!Compile(szProfilePath))
+	{
+		CryLogAlways("[BindingProfile] '%s' is not a valid binding profile, using the built-in bindings.", szProfilePath);
+		CompileDefaults();
+		return false;
+	}
+
+	if (szCachePath)
+	{
+		WriteCache(szCachePath, sourcePathCrc, sourceModificationTime);
+	}
+	return true;
+}
+
+void CPlayerBindingProfile::Unload()
+{
+	if (m_pCacheFile && gEnv && gEnv->pCryPak)
+	{
+		gEnv->pCryPak->FClose(m_pCacheFile);
+	}
+	m_pCacheFile = nullptr;
+
+	m_compiledBindings.clear();
+	m_pBindings = nullptr;
+	m_bindingCount = 0;
+}
+
+bool CPlayerBindingProfile::MapCache(const char* szCachePath, uint32 sourcePathCrc, uint64 sourceModificationTime)
+{
+	FILE* pFile = gEnv->pCryPak->FOpen(szCachePath, "rb", ICryPak::FLAGS_NEVER_IN_PAK | ICryPak::FOPEN_ONDISK);
+	if (!pFile)
+		return false;
+
+	// The bindings are used in place, the file stays open until Unload
+	size_t fileSize = 0;
+	const uint8* pData = static_cast<const uint8*>(gEnv->pCryPak->FGetCachedFileData(pFile, fileSize));
+	const SFileHeader* pHeader = reinterpret_cast<const SFileHeader*>(pData);
+
+	const bool bValid = pData
+		&& fileSize >= sizeof(SFileHeader)
+		&& pHeader->magic == FileMagic
+		&& pHeader->version == FileVersion
+		&& pHeader->sourcePathCrc == sourcePathCrc
+		&& pHeader->sourceModificationTime == sourceModificationTime
+		&& fileSize >= sizeof(SFileHeader) + pHeader->bindingCount * sizeof(SBinding);
+
+	if (!bValid)
+	{
+		gEnv->pCryPak->FClose(pFile);
+		return false;
+	}
+
+	m_pCacheFile = pFile;
+	m_pBindings = reinterpret_cast<const SBinding*>(pData + sizeof(SFileHeader));
+	m_bindingCount = pHeader->bindingCount;
+
+	CryLogAlways("[BindingProfile] Mapped %u bindings from '%s'.", m_bindingCount, szCachePath);
+	return true;
+}
+
+bool CPlayerBindingProfile::Compile(const char* szProfilePath)
+{
+	XmlNodeRef root = gEnv->pSystem->LoadXmlFromFile(szProfilePath);
+	if (!root || !root->isTag("PlayerBindings"))
+		return false;
+
+	m_compiledBindings.clear();
+	for (int i = 0; i < root->getChildCount(); ++i)
+	{
+		XmlNodeRef actionNode = root->getChild(i);
+		if (!actionNode->isTag("Action"))
+			continue;
+
+		const char* szActionName = actionNode->getAttr("name");
+		const EPlayerInputAction action = PlayerInput::FindAction(szActionName);
+		if (action == EPlayerInputAction::Count)
+		{
+			CryLogAlways("[BindingProfile] Skipping unknown action '%s'.", szActionName);
+			continue;
+		}
+
+		for (int j = 0; j < actionNode->getChildCount(); ++j)
+		{
+			XmlNodeRef keyNode = actionNode->getChild(j);
+			if (!keyNode->isTag("Key"))
+				continue;
+
+			const char* szKeyName = keyNode->getAttr("name");
+			const EKeyId keyId = KeyMapper::UserFriendlyNameToKeyId(szKeyName);
+			if (keyId == eKI_Unknown)
+			{
+				CryLogAlways("[BindingProfile] Skipping unknown key '%s' on action '%s'.", szKeyName, szActionName);
+				continue;
+			}
+
+			AddBinding(action, keyId);
+		}
+	}
+
+	m_pBindings = m_compiledBindings.data();
+	m_bindingCount = static_cast<uint32>(m_compiledBindings.size());
+
+	CryLogAlways("[BindingProfile] Compiled %u bindings from '%s'.", m_bindingCount, szProfilePath);
+	return true;
+}
+
+void CPlayerBindingProfile::CompileDefaults()
+{
+	m_compiledBindings.clear();
+	for (const SDefaultBinding& binding : s_defaultBindings)
+	{
+		AddBinding(binding.action, binding.keyId);
+	}
+
+	m_pBindings = m_compiledBindings.data();
+	m_bindingCount = static_cast<uint32>(m_compiledBindings.size());
+}
+
+void CPlayerBindingProfile::WriteCache(const char* szCachePath, uint32 sourcePathCrc, uint64 sourceModificationTime) const
+{
+	FILE* pFile = gEnv->pCryPak->FOpen(szCachePath, "wb", ICryPak::FLAGS_NEVER_IN_PAK | ICryPak::FOPEN_ONDISK);
+	if (!pFile)
+	{
+		CryLogAlways("[BindingProfile] Failed to open '%s' for writing.", szCachePath);
+		return;
+	}
+
+	SFileHeader header;
+	header.magic = FileMagic;
+	header.version = FileVersion;
+	header.bindingCount = m_bindingCount;
+	header.sourcePathCrc = sourcePathCrc;
+	header.sourceModificationTime = sourceModificationTime;
+
+	gEnv->pCryPak->FWrite(&header, sizeof(header), 1, pFile);
+	if (m_bindingCount > 0)
+	{
+		gEnv->pCryPak->FWrite(m_pBindings, sizeof(SBinding), m_bindingCount, pFile);
+	}
+	gEnv->pCryPak->FClose(pFile);
+}
+
+void CPlayerBindingProfile::AddBinding(EPlayerInputAction action, EKeyId keyId)
+{
+	const EPlayerInputDevice device = PlayerInput::GetKeyDevice(keyId);
+	if (device == EPlayerInputDevice::Count)
+	{
+		CryLogAlways("[BindingProfile] Key %u of action '%s' is not on a supported device.", static_cast<uint32>(keyId), PlayerInput::GetActionName(action));
+		return;
+	}
+
+	SBinding binding;
+	binding.action = static_cast<uint8>(action);
+	binding.device = static_cast<uint8>(device);
+	binding.reserved = 0;
+	binding.keyId = static_cast<uint32>(keyId);
+
+	// An action holds one key per device, a later entry replaces the earlier one
+	for (SBinding& existing : m_compiledBindings)
+	{
+		if (existing.action == binding.action && existing.device == binding.device)
+		{
+			existing = binding;
+			return;
+		}
+	}
+	m_compiledBindings.push_back(binding);
+}
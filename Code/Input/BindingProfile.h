@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "Input/PlayerInputActions.h"
+
+////////////////////////////////////////////////////////
+// Player key bindings for every input device, read from an
+// XML binding profile. The profile is compiled into a flat
+// binary cache on first load, later starts map the cache
+// directly as long as it is newer than the profile.
+////////////////////////////////////////////////////////
+class CPlayerBindingProfile
+{
+public:
+	// One compiled binding, 8 bytes on disk
+	struct SBinding
+	{
+		uint8 action;  // EPlayerInputAction
+		uint8 device;  // EPlayerInputDevice
+		uint16 reserved;
+		uint32 keyId;  // EKeyId
+	};
+	static_assert(sizeof(SBinding) == 8, "Compiled binding layout is part of the file format");
+
+	struct SFileHeader
+	{
+		uint32 magic;
+		uint32 version;
+		uint32 bindingCount;
+		uint32 sourcePathCrc;          // Of the XML profile the cache was compiled from, lowercase
+		uint64 sourceModificationTime;
+	};
+
+	static constexpr uint32 FileMagic = 'PBND';
+	static constexpr uint32 FileVersion = 2;
+
+	static CPlayerBindingProfile& Get();
+
+	~CPlayerBindingProfile();
+
+	// Falls back to the built-in bindings if the profile is missing or invalid, so there is always something to apply.
+	// Returns false when the fallback was used. Without a cache path the profile is always compiled and not cached.
+	bool Load(const char* szProfilePath, const char* szCachePath);
+	void Unload();
+	bool IsLoaded() const { return m_pBindings != nullptr; }
+
+	const SBinding* GetBindings() const { return m_pBindings; }
+	uint32 GetBindingCount() const { return m_bindingCount; }
+
+private:
+	bool MapCache(const char* szCachePath, uint32 sourcePathCrc, uint64 sourceModificationTime);
+	bool Compile(const char* szProfilePath);
+	void CompileDefaults();
+	void WriteCache(const char* szCachePath, uint32 sourcePathCrc, uint64 sourceModificationTime) const;
+	void AddBinding(EPlayerInputAction action, EKeyId keyId);
+
+	// Set while the bindings point into the mapped cache file
+	FILE* m_pCacheFile = nullptr;
+	std::vector<SBinding> m_compiledBindings;
+
+	const SBinding* m_pBindings = nullptr;
+	uint32 m_bindingCount = 0;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+
+#include "Input/PlayerInputActions.h"
+
+enum class EPlayerBindResult : uint8
+{
+	Bound,
+	Unchanged,      // The action already uses the key
+	Conflict,       // Another action uses the key on its device
+	UnsupportedKey, // The key is not on a bindable device
+	Failed          // The action map refused the binding
+};
+
+////////////////////////////////////////////////////////
+// Which key each action uses on every device, plus the
+// reverse key -> action index. Both directions are plain
+// array lookups.
+////////////////////////////////////////////////////////
+class CPlayerBindingTable
+{
+public:
+	CPlayerBindingTable() { Clear(); }
+
+	void Clear()
+	{
+		for (std::array<EKeyId, PlayerInput::ActionCount>& deviceKeyIds : m_keyIds)
+		{
+			deviceKeyIds.fill(eKI_Unknown);
+		}
+		m_actions.fill(EPlayerInputAction::Count);
+	}
+
+	// eKI_Unknown if the action is not bound on the device
+	EKeyId GetKey(EPlayerInputDevice device, EPlayerInputAction action) const
+	{
+		return m_keyIds[static_cast<size_t>(device)][static_cast<size_t>(action)];
+	}
+
+	// EPlayerInputAction::Count if no action uses the key
+	EPlayerInputAction GetAction(EKeyId keyId) const
+	{
+		const size_t slot = GetKeySlot(keyId);
+		return slot < KeySlotCount ? m_actions[slot] : EPlayerInputAction::Count;
+	}
+
+	static bool IsBindable(EKeyId keyId) { return GetKeySlot(keyId) < KeySlotCount; }
+
+	// Moves the action to the key on the key's device. A key taken from another action
+	// leaves that action inconsistent until it is moved as well, see FindConflict.
+	void SetKey(EPlayerInputAction action, EKeyId keyId)
+	{
+		const EPlayerInputDevice device = PlayerInput::GetKeyDevice(keyId);
+		if (!IsBindable(keyId) || action >= EPlayerInputAction::Count)
+			return;
+
+		EKeyId& boundKeyId = m_keyIds[static_cast<size_t>(device)][static_cast<size_t>(action)];
+		const size_t previousSlot = GetKeySlot(boundKeyId);
+		if (previousSlot < KeySlotCount && m_actions[previousSlot] == action)
+		{
+			m_actions[previousSlot] = EPlayerInputAction::Count;
+		}
+
+		boundKeyId = keyId;
+		m_actions[GetKeySlot(keyId)] = action;
+	}
+
+	// Finds an action whose key was taken over by another action, returns false if every key has a single action
+	bool FindConflict(EKeyId& keyId, EPlayerInputAction& action, EPlayerInputAction& otherAction) const
+	{
+		for (size_t device = 0; device < PlayerInput::DeviceCount; ++device)
+		{
+			for (size_t i = 0; i < PlayerInput::ActionCount; ++i)
+			{
+				const EKeyId boundKeyId = m_keyIds[device][i];
+				const EPlayerInputAction owner = GetAction(boundKeyId);
+				if (boundKeyId != eKI_Unknown && owner != static_cast<EPlayerInputAction>(i))
+				{
+					keyId = boundKeyId;
+					action = static_cast<EPlayerInputAction>(i);
+					otherAction = owner;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+private:
+	// Key ids of a device start at its KI_*_BASE, the reverse index gives each device a dense range
+	static constexpr uint32 KeyboardMouseKeyCount = KI_XINPUT_BASE;
+	static constexpr uint32 XboxKeyCount = 64;
+	static constexpr uint32 OrbisKeyCount = 64;
+	static constexpr uint32 OculusKeyCount = eKI_Motion_OculusTouch_NUM_SYMBOLS - KI_MOTION_BASE;
+	static constexpr size_t KeySlotCount = KeyboardMouseKeyCount + XboxKeyCount + OrbisKeyCount + OculusKeyCount;
+
+	// KeySlotCount for keys outside the indexed ranges
+	static size_t GetKeySlot(EKeyId keyId)
+	{
+		const uint32 id = static_cast<uint32>(keyId);
+		switch (PlayerInput::GetKeyDevice(keyId))
+		{
+		case EPlayerInputDevice::KeyboardMouse:
+			return id;
+		case EPlayerInputDevice::Xbox:
+			return id - KI_XINPUT_BASE < XboxKeyCount ? KeyboardMouseKeyCount + id - KI_XINPUT_BASE : KeySlotCount;
+		case EPlayerInputDevice::Orbis:
+			return id - KI_ORBIS_BASE < OrbisKeyCount ? KeyboardMouseKeyCount + XboxKeyCount + id - KI_ORBIS_BASE : KeySlotCount;
+		case EPlayerInputDevice::Oculus:
+			return KeyboardMouseKeyCount + XboxKeyCount + OrbisKeyCount + id - KI_MOTION_BASE;
+		default:
+			return KeySlotCount;
+		}
+	}
+
+	std::array<std::array<EKeyId, PlayerInput::ActionCount>, PlayerInput::DeviceCount> m_keyIds;
+	std::array<EPlayerInputAction, KeySlotCount> m_actions;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "Input/PlayerInputActions.h"
+
+////////////////////////////////////////////////////////
+// Fixed capacity single-producer/single-consumer ring buffer.
+// Push is only called by the producer thread and Pop/Clear only by
+// the consumer thread, neither side locks or allocates.
+////////////////////////////////////////////////////////
+template<typename T, uint32 Capacity>
+class CSpscRingBuffer
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	// Over-aligned, so heap instances take memory with the matching alignment
+	static void* operator new(size_t size) { return CryModuleMemalign(size, alignof(CSpscRingBuffer)); }
+	static void  operator delete(void* pMemory) { CryModuleMemalignFree(pMemory); }
+
+	bool TryPush(const T& item)
+	{
+		const uint32 head = m_head.load(std::memory_order_relaxed);
+		if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+			return false;
+
+		m_items[head & (Capacity - 1)] = item;
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool TryPop(T& item)
+	{
+		const uint32 tail = m_tail.load(std::memory_order_relaxed);
+		if (tail == m_head.load(std::memory_order_acquire))
+			return false;
+
+		item = m_items[tail & (Capacity - 1)];
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Discards everything pushed so far, consumer side only
+	void Clear()
+	{
+		m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+	}
+
+	uint32 GetSize() const
+	{
+		return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+	}
+
+private:
+	// Producer and consumer indices live on separate cache lines to avoid false sharing
+	alignas(64) std::atomic<uint32> m_head{ 0 };
+	alignas(64) std::atomic<uint32> m_tail{ 0 };
+	std::array<T, Capacity> m_items;
+};
+
+// An input action as delivered by the input component, waiting to be applied by the player update
+struct SPlayerInputEvent
+{
+	int64 timestamp; // CryGetTicks() when the callback fired
+	float value;
+	uint16 activationMode;
+	EPlayerInputAction action;
+};
+
+typedef CSpscRingBuffer<SPlayerInputEvent, 256> TPlayerInputQueue;
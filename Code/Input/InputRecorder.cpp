@@ -0,0 +1,215 @@
+#include "StdAfx.h"
+#include "InputRecorder.h"
+#include "Components/Player.h"
+
+#include <CrySystem/IConsole.h>
+#include <CrySystem/ITimer.h>
+#include <CrySystem/File/ICryPak.h>
+
+namespace
+{
+	// Enough for several minutes of play without reallocating while recording
+	static constexpr size_t InitialRecordCapacity = 64 * 1024;
+	static constexpr const char* DefaultRecordingPath = "%USER%/player_input.pinr";
+}
+
+CPlayerInputRecorder& CPlayerInputRecorder::Get()
+{
+	static CPlayerInputRecorder s_instance;
+	return s_instance;
+}
+
+void CPlayerInputRecorder::StartRecording(EntityId entityId)
+{
+	StopReplay();
+
+	m_records.clear();
+	m_records.reserve(InitialRecordCapacity);
+	m_recordEntityId = entityId;
+	m_bStartStateCaptured = false;
+	m_bRecording = true;
+}
+
+void CPlayerInputRecorder::StopRecording()
+{
+	m_bRecording = false;
+}
+
+void CPlayerInputRecorder::Record(const CPlayerComponent& player, EPlayerInputAction action, int activationMode, float value)
+{
+	if (!m_bRecording)
+		return;
+
+	if (m_recordEntityId == INVALID_ENTITYID)
+	{
+		m_recordEntityId = player.GetEntityId();
+	}
+	else if (m_recordEntityId != player.GetEntityId())
+	{
+		return;
+	}
+
+	// The state before the first action is applied, frame 0 of the recording
+	if (!m_bStartStateCaptured)
+	{
+		player.CaptureInputStartState(m_startState);
+		m_bStartStateCaptured = true;
+		m_recordStartFrame = gEnv->nMainFrameID;
+		m_recordStartTime = gEnv->pTimer->GetFrameStartTime().GetSeconds();
+	}
+
+	SRecord record;
+	record.frame = static_cast<uint32>(max(gEnv->nMainFrameID - m_recordStartFrame, 0));
+	record.time = gEnv->pTimer->GetFrameStartTime().GetSeconds() - m_recordStartTime;
+	record.activationMode = static_cast<uint16>(activationMode);
+	record.action = static_cast<uint8>(action);
+	record.reserved = 0;
+	record.value = value;
+	m_records.push_back(record);
+}
+
+bool CPlayerInputRecorder::Save(const char* szPath) const
+{
+	FILE* pFile = gEnv->pCryPak->FOpen(szPath, "wb", ICryPak::FLAGS_NEVER_IN_PAK | ICryPak::FOPEN_ONDISK);
+	if (!pFile)
+	{
+		CryLogAlways("[InputRecorder] Failed to open '%s' for writing.", szPath);
+		return false;
+	}
+
+	SFileHeader header;
+	header.magic = FileMagic;
+	header.version = FileVersion;
+	header.recordCount = static_cast<uint32>(m_records.size());
+	header.reserved = 0;
+	header.startState = m_startState;
+
+	gEnv->pCryPak->FWrite(&header, sizeof(header), 1, pFile);
+	if (!m_records.empty())
+	{
+		gEnv->pCryPak->FWrite(m_records.data(), sizeof(SRecord), m_records.size(), pFile);
+	}
+	gEnv->pCryPak->FClose(pFile);
+
+	CryLogAlways("[InputRecorder] Saved %u input records to '%s'.", header.recordCount, szPath);
+	return true;
+}
+
+bool CPlayerInputRecorder::Load(const char* szPath)
+{
+	FILE* pFile = gEnv->pCryPak->FOpen(szPath, "rb");
+	if (!pFile)
+	{
+		CryLogAlways("[InputRecorder] Failed to open '%s'.", szPath);
+		return false;
+	}
+
+	SFileHeader header;
+	const size_t fileSize = gEnv->pCryPak->FGetSize(pFile);
+	const bool bValidHeader = fileSize >= sizeof(header)
+		&& gEnv->pCryPak->FReadRaw(&header, sizeof(header), 1, pFile) == 1
+		&& header.magic == FileMagic
+		&& header.version == FileVersion
+		&& fileSize >= sizeof(header) + header.recordCount * sizeof(SRecord);
+
+	if (!bValidHeader)
+	{
+		gEnv->pCryPak->FClose(pFile);
+		CryLogAlways("[InputRecorder] '%s' is not a valid input recording.", szPath);
+		return false;
+	}
+
+	m_startState = header.startState;
+	m_records.resize(header.recordCount);
+	if (header.recordCount > 0)
+	{
+		gEnv->pCryPak->FReadRaw(m_records.data(), sizeof(SRecord), header.recordCount, pFile);
+	}
+	gEnv->pCryPak->FClose(pFile);
+
+	CryLogAlways("[InputRecorder] Loaded %u input records from '%s'.", header.recordCount, szPath);
+	return true;
+}
+
+void CPlayerInputRecorder::StartReplay(EntityId entityId)
+{
+	StopRecording();
+
+	m_replayEntityId = entityId;
+	m_replayFrame = 0;
+	m_replayIndex = 0;
+	m_bReplaying = true;
+}
+
+void CPlayerInputRecorder::StopReplay()
+{
+	m_bReplaying = false;
+	m_replayEntityId = INVALID_ENTITYID;
+}
+
+void CPlayerInputRecorder::UpdateReplay(CPlayerComponent& player)
+{
+	if (!m_bReplaying)
+		return;
+
+	if (m_replayEntityId == INVALID_ENTITYID)
+	{
+		m_replayEntityId = player.GetEntityId();
+	}
+	else if (m_replayEntityId != player.GetEntityId())
+	{
+		return;
+	}
+
+	// Start from where the recorded player was, otherwise the same input leads somewhere else
+	if (m_replayFrame == 0)
+	{
+		player.RestoreInputStartState(m_startState);
+	}
+
+	while (m_replayIndex < m_records.size() && m_records[m_replayIndex].frame <= m_replayFrame)
+	{
+		const SRecord& record = m_records[m_replayIndex++];
+		if (record.action < static_cast<uint8>(EPlayerInputAction::Count))
+		{
+			player.HandleInputAction(static_cast<EPlayerInputAction>(record.action), record.activationMode, record.value);
+		}
+	}
+
+	++m_replayFrame;
+
+	if (m_replayIndex >= m_records.size())
+	{
+		CryLogAlways("[InputRecorder] Replay finished after %u frames.", m_replayFrame);
+		StopReplay();
+	}
+}
+
+void CPlayerInputRecorder::CmdRecord(IConsoleCmdArgs* pArgs)
+{
+	CPlayerInputRecorder& recorder = Get();
+	recorder.m_recordPath = pArgs->GetArgCount() > 1 ? pArgs->GetArg(1) : DefaultRecordingPath;
+	recorder.StartRecording();
+	CryLogAlways("[InputRecorder] Recording player input to '%s'.", recorder.m_recordPath.c_str());
+}
+
+void CPlayerInputRecorder::CmdStop(IConsoleCmdArgs* pArgs)
+{
+	CPlayerInputRecorder& recorder = Get();
+	if (recorder.m_bRecording)
+	{
+		recorder.StopRecording();
+		recorder.Save(recorder.m_recordPath.c_str());
+	}
+	recorder.StopReplay();
+}
+
+void CPlayerInputRecorder::CmdReplay(IConsoleCmdArgs* pArgs)
+{
+	CPlayerInputRecorder& recorder = Get();
+	const char* szPath = pArgs->GetArgCount() > 1 ? pArgs->GetArg(1) : DefaultRecordingPath;
+	if (recorder.Load(szPath))
+	{
+		recorder.StartReplay();
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+
+#include "Input/PlayerInputActions.h"
+
+class CPlayerComponent;
+struct IConsoleCmdArgs;
+
+// Player state a recording starts from, restored before the first recorded action is replayed
+struct SPlayerInputStartState
+{
+	Vec3 position;
+	Quat rotation;
+	Quat yaw;
+	Vec3 velocity;
+	Vec2 movementDelta;
+	Vec2 lookStickDeflection;
+	float pitch;
+	uint32 reserved;
+};
+static_assert(sizeof(SPlayerInputStartState) == 80, "Recorded start state layout is part of the file format");
+
+////////////////////////////////////////////////////////
+// Records the input actions reaching a player's input
+// callbacks into a compact binary file and replays them
+// into a player without any real devices attached.
+////////////////////////////////////////////////////////
+class CPlayerInputRecorder
+{
+public:
+	// One recorded input action, 16 bytes on disk
+	struct SRecord
+	{
+		uint32 frame;          // Frames since the recording started
+		float time;            // Seconds since the recording started
+		uint16 activationMode; // EActionActivationMode flags
+		uint8 action;          // EPlayerInputAction
+		uint8 reserved;
+		float value;
+	};
+	static_assert(sizeof(SRecord) == 16, "Recorded input layout is part of the file format");
+
+	struct SFileHeader
+	{
+		uint32 magic;
+		uint32 version;
+		uint32 recordCount;
+		uint32 reserved;
+		SPlayerInputStartState startState;
+	};
+
+	static constexpr uint32 FileMagic = 'PINR';
+	static constexpr uint32 FileVersion = 3;
+
+	static CPlayerInputRecorder& Get();
+
+	// Recording, INVALID_ENTITYID records the first player that receives input.
+	// Frames count from the player's first action, its state at that point is saved with the records.
+	void StartRecording(EntityId entityId = INVALID_ENTITYID);
+	void StopRecording();
+	bool IsRecording() const { return m_bRecording; }
+	void Record(const CPlayerComponent& player, EPlayerInputAction action, int activationMode, float value);
+
+	bool Save(const char* szPath) const;
+	bool Load(const char* szPath);
+
+	// Replay, INVALID_ENTITYID replays into the first player that updates
+	void StartReplay(EntityId entityId = INVALID_ENTITYID);
+	void StopReplay();
+	bool IsReplaying(EntityId entityId) const { return m_bReplaying && m_replayEntityId == entityId; }
+
+	// Called once per player update, feeds all records that are due this frame into the player
+	void UpdateReplay(CPlayerComponent& player);
+
+	// Console commands
+	static void CmdRecord(IConsoleCmdArgs* pArgs);
+	static void CmdStop(IConsoleCmdArgs* pArgs);
+	static void CmdReplay(IConsoleCmdArgs* pArgs);
+
+private:
+	std::vector<SRecord> m_records;
+	SPlayerInputStartState m_startState;
+	string m_recordPath;
+
+	bool m_bRecording = false;
+	bool m_bStartStateCaptured = false;
+	EntityId m_recordEntityId = INVALID_ENTITYID;
+	int m_recordStartFrame = 0;
+	float m_recordStartTime = 0.f;
+
+	bool m_bReplaying = false;
+	EntityId m_replayEntityId = INVALID_ENTITYID;
+	uint32 m_replayFrame = 0;
+	size_t m_replayIndex = 0;
+};
@@ -0,0 +1,483 @@
+#include "StdAfx.h"
+#include "KeyMapper.h"
+
+#include <array>
+
+namespace
+{
+	struct SKeyName
+	{
+		EKeyId keyId;
+		std::string_view name;
+	};
+
+	static constexpr SKeyName s_keyNames[] =
+	{
+		// Keyboard keys
+		{ eKI_Escape, "Escape" },
+		{ eKI_1, "1" },
+		{ eKI_2, "2" },
+		{ eKI_3, "3" },
+		{ eKI_4, "4" },
+		{ eKI_5, "5" },
+		{ eKI_6, "6" },
+		{ eKI_7, "7" },
+		{ eKI_8, "8" },
+		{ eKI_9, "9" },
+		{ eKI_0, "0" },
+		{ eKI_Minus, "Minus" },
+		{ eKI_Equals, "Equals" },
+		{ eKI_Backspace, "Backspace" },
+		{ eKI_Tab, "Tab" },
+		{ eKI_Q, "Q" },
+		{ eKI_W, "W" },
+		{ eKI_E, "E" },
+		{ eKI_R, "R" },
+		{ eKI_T, "T" },
+		{ eKI_Y, "Y" },
+		{ eKI_U, "U" },
+		{ eKI_I, "I" },
+		{ eKI_O, "O" },
+		{ eKI_P, "P" },
+		{ eKI_LBracket, "LBracket" },
+		{ eKI_RBracket, "RBracket" },
+		{ eKI_Enter, "Enter" },
+		{ eKI_LCtrl, "LCtrl" },
+		{ eKI_A, "A" },
+		{ eKI_S, "S" },
+		{ eKI_D, "D" },
+		{ eKI_F, "F" },
+		{ eKI_G, "G" },
+		{ eKI_H, "H" },
+		{ eKI_J, "J" },
+		{ eKI_K, "K" },
+		{ eKI_L, "L" },
+		{ eKI_Semicolon, "Semicolon" },
+		{ eKI_Apostrophe, "Apostrophe" },
+		{ eKI_Tilde, "Tilde" },
+		{ eKI_LShift, "LShift" },
+		{ eKI_Backslash, "Backslash" },
+		{ eKI_Z, "Z" },
+		{ eKI_X, "X" },
+		{ eKI_C, "C" },
+		{ eKI_V, "V" },
+		{ eKI_B, "B" },
+		{ eKI_N, "N" },
+		{ eKI_M, "M" },
+		{ eKI_Comma, "Comma" },
+		{ eKI_Period, "Period" },
+		{ eKI_Slash, "Slash" },
+		{ eKI_RShift, "RShift" },
+		{ eKI_NP_Multiply, "NPMultiply" },
+		{ eKI_LAlt, "LAlt" },
+		{ eKI_Space, "Space" },
+		{ eKI_CapsLock, "CapsLock" },
+		{ eKI_F1, "F1" },
+		{ eKI_F2, "F2" },
+		{ eKI_F3, "F3" },
+		{ eKI_F4, "F4" },
+		{ eKI_F5, "F5" },
+		{ eKI_F6, "F6" },
+		{ eKI_F7, "F7" },
+		{ eKI_F8, "F8" },
+		{ eKI_F9, "F9" },
+		{ eKI_F10, "F10" },
+		{ eKI_NumLock, "NumLock" },
+		{ eKI_ScrollLock, "ScrollLock" },
+		{ eKI_NP_7, "NP7" },
+		{ eKI_NP_8, "NP8" },
+		{ eKI_NP_9, "NP9" },
+		{ eKI_NP_Substract, "NPSubstract" },
+		{ eKI_NP_4, "NP4" },
+		{ eKI_NP_5, "NP5" },
+		{ eKI_NP_6, "NP6" },
+		{ eKI_NP_Add, "NPAdd" },
+		{ eKI_NP_1, "NP1" },
+		{ eKI_NP_2, "NP2" },
+		{ eKI_NP_3, "NP3" },
+		{ eKI_NP_0, "NP0" },
+		{ eKI_F11, "F11" },
+		{ eKI_F12, "F12" },
+		{ eKI_F13, "F13" },
+		{ eKI_F14, "F14" },
+		{ eKI_F15, "F15" },
+		{ eKI_Colon, "Colon" },
+		{ eKI_Underline, "Underline" },
+		{ eKI_NP_Enter, "NPEnter" },
+		{ eKI_RCtrl, "RCtrl" },
+		{ eKI_NP_Period, "NPPeriod" },
+		{ eKI_NP_Divide, "NPDivide" },
+		{ eKI_Print, "Print" },
+		{ eKI_RAlt, "RAlt" },
+		{ eKI_Pause, "Pause" },
+		{ eKI_Home, "Home" },
+		{ eKI_Up, "Up" },
+		{ eKI_PgUp, "PgUp" },
+		{ eKI_Left, "Left" },
+		{ eKI_Right, "Right" },
+		{ eKI_End, "End" },
+		{ eKI_Down, "Down" },
+		{ eKI_PgDn, "PgDn" },
+		{ eKI_Insert, "Insert" },
+		{ eKI_Delete, "Delete" },
+		{ eKI_LWin, "LWin" },
+		{ eKI_RWin, "RWin" },
+		{ eKI_Apps, "Apps" },
+		{ eKI_OEM_102, "OEM102" },
+
+		// Mouse buttons
+		{ eKI_Mouse1, "Mouse1" },
+		{ eKI_Mouse2, "Mouse2" },
+		{ eKI_Mouse3, "Mouse3" },
+		{ eKI_Mouse4, "Mouse4" },
+		{ eKI_Mouse5, "Mouse5" },
+		{ eKI_Mouse6, "Mouse6" },
+		{ eKI_Mouse7, "Mouse7" },
+		{ eKI_Mouse8, "Mouse8" },
+		{ eKI_MouseWheelUp, "MouseWheelUp" },
+		{ eKI_MouseWheelDown, "MouseWheelDown" },
+		{ eKI_MouseX, "MouseX" },
+		{ eKI_MouseY, "MouseY" },
+		{ eKI_MouseZ, "MouseZ" },
+		{ eKI_MouseXAbsolute, "MouseXAbsolute" },
+		{ eKI_MouseYAbsolute, "MouseYAbsolute" },
+
+		// Xbox controller
+		{ eKI_XI_DPadUp, "XI_DPadUp" },
+		{ eKI_XI_DPadDown, "XI_DPadDown" },
+		{ eKI_XI_DPadLeft, "XI_DPadLeft" },
+		{ eKI_XI_DPadRight, "XI_DPadRight" },
+		{ eKI_XI_Start, "XI_Start" },
+		{ eKI_XI_Back, "XI_Back" },
+		{ eKI_XI_ThumbL, "XI_ThumbL" },
+		{ eKI_XI_ThumbR, "XI_ThumbR" },
+		{ eKI_XI_ShoulderL, "XI_ShoulderL" },
+		{ eKI_XI_ShoulderR, "XI_ShoulderR" },
+		{ eKI_XI_A, "XI_A" },
+		{ eKI_XI_B, "XI_B" },
+		{ eKI_XI_X, "XI_X" },
+		{ eKI_XI_Y, "XI_Y" },
+		{ eKI_XI_TriggerL, "XI_TriggerL" },
+		{ eKI_XI_TriggerR, "XI_TriggerR" },
+		{ eKI_XI_ThumbLX, "XI_ThumbLX" },
+		{ eKI_XI_ThumbLY, "XI_ThumbLY" },
+		{ eKI_XI_ThumbLUp, "XI_ThumbLUp" },
+		{ eKI_XI_ThumbLDown, "XI_ThumbLDown" },
+		{ eKI_XI_ThumbLLeft, "XI_ThumbLLeft" },
+		{ eKI_XI_ThumbLRight, "XI_ThumbLRight" },
+		{ eKI_XI_ThumbRX, "XI_ThumbRX" },
+		{ eKI_XI_ThumbRY, "XI_ThumbRY" },
+		{ eKI_XI_ThumbRUp, "XI_ThumbRUp" },
+		{ eKI_XI_ThumbRDown, "XI_ThumbRDown" },
+		{ eKI_XI_ThumbRLeft, "XI_ThumbRLeft" },
+		{ eKI_XI_ThumbRRight, "XI_ThumbRRight" },
+
+		// Orbis controller
+		{ eKI_Orbis_Options, "Orbis_Options" },
+		{ eKI_Orbis_L3, "Orbis_L3" },
+		{ eKI_Orbis_R3, "Orbis_R3" },
+		{ eKI_Orbis_Up, "Orbis_Up" },
+		{ eKI_Orbis_Right, "Orbis_Right" },
+		{ eKI_Orbis_Down, "Orbis_Down" },
+		{ eKI_Orbis_Left, "Orbis_Left" },
+		{ eKI_Orbis_L2, "Orbis_L2" },  // L2 as button, for trigger use LeftTrigger.
+		{ eKI_Orbis_R2, "Orbis_R2" },  // R2 as button, for trigger use RightTrigger.
+		{ eKI_Orbis_L1, "Orbis_L1" },
+		{ eKI_Orbis_R1, "Orbis_R1" },
+		{ eKI_Orbis_Triangle, "Orbis_Triangle" },
+		{ eKI_Orbis_Circle, "Orbis_Circle" },
+		{ eKI_Orbis_Cross, "Orbis_Cross" },
+		{ eKI_Orbis_Square, "Orbis_Square" },
+		{ eKI_Orbis_StickLX, "Orbis_StickLX" },
+		{ eKI_Orbis_StickLY, "Orbis_StickLY" },
+		{ eKI_Orbis_StickRX, "Orbis_StickRX" },
+		{ eKI_Orbis_StickRY, "Orbis_StickRY" },
+		{ eKI_Orbis_RotX, "Orbis_RotX" },
+		{ eKI_Orbis_RotY, "Orbis_RotY" },
+		{ eKI_Orbis_RotZ, "Orbis_RotZ" },
+		{ eKI_Orbis_RotX_KeyL, "Orbis_RotX_KeyL" },
+		{ eKI_Orbis_RotX_KeyR, "Orbis_RotX_KeyR" },
+		{ eKI_Orbis_RotZ_KeyD, "Orbis_RotZ_KeyD" },
+		{ eKI_Orbis_RotZ_KeyU, "Orbis_RotZ_KeyU" },
+		{ eKI_Orbis_LeftTrigger, "Orbis_LeftTrigger" },  // L2 as trigger, for button use L2.
+		{ eKI_Orbis_RightTrigger, "Orbis_RightTrigger" }, // R2 as trigger, for button use R2.
+		{ eKI_Orbis_Touch, "Orbis_Touch" },
+
+		// Oculus
+		{ eKI_Motion_OculusTouch_A, "OculusTouch_A" },
+		{ eKI_Motion_OculusTouch_B, "OculusTouch_B" },
+		{ eKI_Motion_OculusTouch_X, "OculusTouch_X" },
+		{ eKI_Motion_OculusTouch_Y, "OculusTouch_Y" },
+		{ eKI_Motion_OculusTouch_L3, "OculusTouch_L3" },  // Left thumb button (stick).
+		{ eKI_Motion_OculusTouch_R3, "OculusTouch_R3" },  // Right thumb button (stick).
+		{ eKI_Motion_OculusTouch_TriggerBtnL, "OculusTouch_TriggerBtnL" },  // Left trigger button.
+		{ eKI_Motion_OculusTouch_TriggerBtnR, "OculusTouch_TriggerBtnR" },  // Right trigger button.
+		{ eKI_Motion_OculusTouch_L1, "OculusTouch_L1" },  // Left index trigger.
+		{ eKI_Motion_OculusTouch_R1, "OculusTouch_R1" },  // Right index trigger.
+		{ eKI_Motion_OculusTouch_L2, "OculusTouch_L2" },  // Left hand trigger.
+		{ eKI_Motion_OculusTouch_R2, "OculusTouch_R2" },  // Right hand trigger.
+		{ eKI_Motion_OculusTouch_StickL_Y, "OculusTouch_StickL_Y" },  // Left stick vertical motion.
+		{ eKI_Motion_OculusTouch_StickR_Y, "OculusTouch_StickR_Y" },  // Right stick vertical motion.
+		{ eKI_Motion_OculusTouch_StickL_X, "OculusTouch_StickL_X" },  // Left stick horizontal motion.
+		{ eKI_Motion_OculusTouch_StickR_X, "OculusTouch_StickR_X" },  // Right stick horizontal motion.
+		{ eKI_Motion_OculusTouch_Gesture_ThumbUpL, "OculusTouch_Gesture_ThumbUpL" },  // Gesture left thumb up.
+		{ eKI_Motion_OculusTouch_Gesture_ThumbUpR, "OculusTouch_Gesture_ThumbUpR" },  // Gesture right thumb up.
+		{ eKI_Motion_OculusTouch_Gesture_IndexPointingL, "OculusTouch_Gesture_IndexPointingL" },  // Gesture left index pointing.
+		{ eKI_Motion_OculusTouch_Gesture_IndexPointingR, "OculusTouch_Gesture_IndexPointingR" },  // Gesture right index pointing.
+
+		// Eye Tracker
+		{ eKI_EyeTracker_X, "EyeTracker_X" },
+		{ eKI_EyeTracker_Y, "EyeTracker_Y" },
+
+		// OpenVR
+		{ eKI_Motion_OpenVR_System, "OpenVR_System" },
+		{ eKI_Motion_OpenVR_ApplicationMenu, "OpenVR_ApplicationMenu" },
+		{ eKI_Motion_OpenVR_Grip, "OpenVR_Grip" },
+		{ eKI_Motion_OpenVR_TouchPad_X, "OpenVR_TouchPad_X" },
+		{ eKI_Motion_OpenVR_TouchPad_Y, "OpenVR_TouchPad_Y" },
+		{ eKI_Motion_OpenVR_Trigger, "OpenVR_Trigger" },
+		{ eKI_Motion_OpenVR_TriggerBtn, "OpenVR_TriggerBtn" },
+		{ eKI_Motion_OpenVR_TouchPadBtn, "OpenVR_TouchPadBtn" }
+	};
+
+	static constexpr size_t KeyCount = sizeof(s_keyNames) / sizeof(s_keyNames[0]);
+	static constexpr uint16 InvalidIndex = 0xFFFF;
+
+	static_assert(KeyCount < InvalidIndex, "Key table index does not fit in 16 bits");
+
+	////////////////////////////////////////////////////////
+	// Name -> id: hash-and-displace perfect hash. Names are
+	// hashed once into a bucket, each bucket gets the smallest
+	// displacement that moves all of its names into free slots.
+	////////////////////////////////////////////////////////
+	static constexpr size_t NameBucketCount = 64;
+	static constexpr size_t NameSlotCount = 512; // Power of two, keeps the load below one half
+	static constexpr uint16 MaxDisplacement = 4096;
+
+	static_assert(KeyCount <= NameSlotCount / 2, "Grow NameSlotCount with the key table");
+
+	constexpr uint64 HashName(std::string_view name)
+	{
+		// FNV-1a
+		uint64 hash = 14695981039346656037ull;
+		for (const char c : name)
+		{
+			hash = (hash ^ static_cast<uint8>(c)) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	constexpr size_t GetNameBucket(uint64 hash)
+	{
+		return static_cast<size_t>(hash % NameBucketCount);
+	}
+
+	// The upper half of the hash is forced odd, so the displacement walks every slot once
+	constexpr size_t GetNameSlot(uint64 hash, uint16 displacement)
+	{
+		return (static_cast<uint32>(hash) + displacement * (static_cast<uint32>(hash >> 32) | 1u)) & (NameSlotCount - 1);
+	}
+
+	struct SNameTable
+	{
+		std::array<uint16, NameBucketCount> displacements{};
+		std::array<uint16, NameSlotCount> slots{};
+		bool bValid = false;
+	};
+
+	constexpr SNameTable BuildNameTable()
+	{
+		SNameTable table;
+		for (uint16& slot : table.slots)
+		{
+			slot = InvalidIndex;
+		}
+
+		std::array<uint64, KeyCount> hashes{};
+		std::array<size_t, NameBucketCount + 1> bucketStart{};
+		for (size_t i = 0; i < KeyCount; ++i)
+		{
+			hashes[i] = HashName(s_keyNames[i].name);
+			++bucketStart[GetNameBucket(hashes[i]) + 1];
+		}
+
+		// Counting sort the keys by bucket
+		size_t maxBucketSize = 0;
+		for (size_t bucket = 0; bucket < NameBucketCount; ++bucket)
+		{
+			maxBucketSize = maxBucketSize > bucketStart[bucket + 1] ? maxBucketSize : bucketStart[bucket + 1];
+			bucketStart[bucket + 1] += bucketStart[bucket];
+		}
+
+		std::array<size_t, NameBucketCount> bucketFill{};
+		std::array<uint16, KeyCount> bucketKeys{};
+		for (size_t i = 0; i < KeyCount; ++i)
+		{
+			const size_t bucket = GetNameBucket(hashes[i]);
+			bucketKeys[bucketStart[bucket] + bucketFill[bucket]++] = static_cast<uint16>(i);
+		}
+
+		// Place the largest buckets first while most slots are still free
+		for (size_t size = maxBucketSize; size > 0; --size)
+		{
+			for (size_t bucket = 0; bucket < NameBucketCount; ++bucket)
+			{
+				const size_t first = bucketStart[bucket];
+				if (bucketStart[bucket + 1] - first != size)
+					continue;
+
+				bool bPlaced = false;
+				for (uint16 displacement = 0; displacement < MaxDisplacement && !bPlaced; ++displacement)
+				{
+					bPlaced = true;
+					for (size_t i = first; i < first + size && bPlaced; ++i)
+					{
+						const size_t slot = GetNameSlot(hashes[bucketKeys[i]], displacement);
+						bPlaced = table.slots[slot] == InvalidIndex;
+
+						// Keys of the same bucket must not collide with each other either
+						for (size_t j = first; j < i && bPlaced; ++j)
+						{
+							bPlaced = GetNameSlot(hashes[bucketKeys[j]], displacement) != slot;
+						}
+					}
+
+					if (bPlaced)
+					{
+						table.displacements[bucket] = displacement;
+						for (size_t i = first; i < first + size; ++i)
+						{
+							table.slots[GetNameSlot(hashes[bucketKeys[i]], displacement)] = bucketKeys[i];
+						}
+					}
+				}
+
+				// Only happens for duplicate names, which hash identically
+				if (!bPlaced)
+					return table;
+			}
+		}
+
+		table.bValid = true;
+		return table;
+	}
+
+	static constexpr SNameTable s_nameTable = BuildNameTable();
+	static_assert(s_nameTable.bValid, "Key names must be unique");
+
+	////////////////////////////////////////////////////////
+	// Id -> name: key ids are grouped per device at fixed
+	// bases, so the id is split into a 256 entry page and an
+	// offset. Only pages that hold keys get a table.
+	////////////////////////////////////////////////////////
+	static constexpr size_t KeyIdPageSize = 256;
+
+	constexpr size_t GetKeyIdPage(uint32 keyId) { return keyId / KeyIdPageSize; }
+
+	constexpr size_t GetMaxKeyIdPage()
+	{
+		size_t maxPage = 0;
+		for (const SKeyName& keyName : s_keyNames)
+		{
+			const size_t page = GetKeyIdPage(static_cast<uint32>(keyName.keyId));
+			maxPage = maxPage > page ? maxPage : page;
+		}
+		return maxPage;
+	}
+
+	static constexpr size_t KeyIdPageDirectorySize = GetMaxKeyIdPage() + 1;
+
+	constexpr size_t CountUsedKeyIdPages()
+	{
+		std::array<bool, KeyIdPageDirectorySize> used{};
+		size_t count = 0;
+		for (const SKeyName& keyName : s_keyNames)
+		{
+			const size_t page = GetKeyIdPage(static_cast<uint32>(keyName.keyId));
+			count += used[page] ? 0 : 1;
+			used[page] = true;
+		}
+		return count;
+	}
+
+	static constexpr size_t KeyIdPageCount = CountUsedKeyIdPages();
+	static constexpr uint8 InvalidPage = 0xFF;
+
+	static_assert(KeyIdPageCount < InvalidPage, "Too many key id pages");
+
+	struct SKeyIdTable
+	{
+		std::array<uint8, KeyIdPageDirectorySize> directory{};
+		std::array<std::array<uint16, KeyIdPageSize>, KeyIdPageCount> pages{};
+		bool bValid = false;
+	};
+
+	constexpr SKeyIdTable BuildKeyIdTable()
+	{
+		SKeyIdTable table;
+		for (uint8& page : table.directory)
+		{
+			page = InvalidPage;
+		}
+		for (std::array<uint16, KeyIdPageSize>& page : table.pages)
+		{
+			for (uint16& entry : page)
+			{
+				entry = InvalidIndex;
+			}
+		}
+
+		uint8 nextPage = 0;
+		for (size_t i = 0; i < KeyCount; ++i)
+		{
+			const uint32 keyId = static_cast<uint32>(s_keyNames[i].keyId);
+			const size_t directoryIndex = GetKeyIdPage(keyId);
+			if (table.directory[directoryIndex] == InvalidPage)
+			{
+				table.directory[directoryIndex] = nextPage++;
+			}
+
+			uint16& entry = table.pages[table.directory[directoryIndex]][keyId % KeyIdPageSize];
+			if (entry != InvalidIndex)
+				return table; // Two names for the same key
+
+			entry = static_cast<uint16>(i);
+		}
+
+		table.bValid = true;
+		return table;
+	}
+
+	static constexpr SKeyIdTable s_keyIdTable = BuildKeyIdTable();
+	static_assert(s_keyIdTable.bValid, "Every key may only be listed once");
+}
+
+std::string_view KeyMapper::KeyIdToUserFriendlyName(EKeyId keyId)
+{
+	const uint32 id = static_cast<uint32>(keyId);
+	const size_t directoryIndex = GetKeyIdPage(id);
+	if (directoryIndex < KeyIdPageDirectorySize)
+	{
+		const uint8 page = s_keyIdTable.directory[directoryIndex];
+		if (page != InvalidPage)
+		{
+			const uint16 index = s_keyIdTable.pages[page][id % KeyIdPageSize];
+			if (index != InvalidIndex)
+				return s_keyNames[index].name;
+		}
+	}
+
+	return "Unknown";
+}
+
+EKeyId KeyMapper::UserFriendlyNameToKeyId(std::string_view keyName)
+{
+	const uint64 hash = HashName(keyName);
+	const uint16 index = s_nameTable.slots[GetNameSlot(hash, s_nameTable.displacements[GetNameBucket(hash)])];
+
+	// The slot holds the only name that can hash there, so one compare decides
+	if (index != InvalidIndex && s_keyNames[index].name == keyName)
+		return s_keyNames[index].keyId;
+
+	return eKI_Unknown; // Default for unmapped keys
+}
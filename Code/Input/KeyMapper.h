@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string_view>
+
+#include <CryInput/IInput.h>
+
+////////////////////////////////////////////////////////
+// Converts between EKeyId and user-friendly key names.
+// Both tables are built at compile time, lookups never
+// allocate and are safe from any thread.
+////////////////////////////////////////////////////////
+class KeyMapper
+{
+public:
+	// Converts an EKeyId to a user-friendly key name (e.g., eKI_W -> "W"), "Unknown" if the key has no name.
+	static std::string_view KeyIdToUserFriendlyName(EKeyId keyId);
+
+	// Converts a user-friendly key name to an EKeyId (e.g., "W" -> eKI_W), eKI_Unknown if the name is not known.
+	static EKeyId UserFriendlyNameToKeyId(std::string_view keyName);
+};
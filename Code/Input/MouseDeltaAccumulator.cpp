@@ -0,0 +1,19 @@
+#include "StdAfx.h"
+#include "MouseDeltaAccumulator.h"
+#include "Components/Player.h"
+
+bool CRawMouseLookListener::OnInputEvent(const SInputEvent& event)
+{
+	// Same mapping as the action bindings, MouseX drives the pitch action and MouseY the yaw action
+	if (event.keyId == eKI_MouseX)
+	{
+		m_player.OnRawLookInput(EPlayerInputAction::Pitch, event.value);
+	}
+	else if (event.keyId == eKI_MouseY)
+	{
+		m_player.OnRawLookInput(EPlayerInputAction::Yaw, event.value);
+	}
+
+	// Never consume, the rest of the game still sees the event
+	return false;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+
+#include <CryInput/IInput.h>
+#include <IActionMapManager.h>
+
+#include "Components/PlayerMemoryPool.h"
+
+class CPlayerComponent;
+
+////////////////////////////////////////////////////////
+// Sums every mouse delta between two player updates.
+// Any thread may add, the player update consumes the sum
+// exactly once. Deltas are stored in fixed point so both
+// sides stay lock-free without a compare-exchange loop.
+////////////////////////////////////////////////////////
+class CMouseDeltaAccumulator
+{
+public:
+	void Add(const Vec2& delta)
+	{
+		m_x.fetch_add(ToFixed(delta.x), std::memory_order_relaxed);
+		m_y.fetch_add(ToFixed(delta.y), std::memory_order_relaxed);
+	}
+
+	// Returns the sum since the last call and restarts from zero
+	Vec2 Consume()
+	{
+		return Vec2(FromFixed(m_x.exchange(0, std::memory_order_relaxed)), FromFixed(m_y.exchange(0, std::memory_order_relaxed)));
+	}
+
+	void Clear()
+	{
+		m_x.store(0, std::memory_order_relaxed);
+		m_y.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	// 1/4096 of a mouse count is well below anything a device reports
+	static constexpr float FixedPointScale = 4096.f;
+
+	static int64 ToFixed(float value) { return static_cast<int64>(value * FixedPointScale); }
+	static float FromFixed(int64 value) { return static_cast<float>(value) / FixedPointScale; }
+
+	std::atomic<int64> m_x{ 0 };
+	std::atomic<int64> m_y{ 0 };
+};
+
+////////////////////////////////////////////////////////
+// Takes raw mouse motion from the input system's event
+// dispatch and hands it to its player, bypassing the
+// per-action callbacks (pl_rawMouseLook 1). Events arrive
+// on the main thread during the frame's input update.
+// Only enabled for the local player.
+////////////////////////////////////////////////////////
+class CRawMouseLookListener final : public IInputEventListener
+{
+public:
+	PLAYER_MEMORY_POOL_ALLOCATED
+
+	explicit CRawMouseLookListener(CPlayerComponent& player)
+		: m_player(player)
+	{
+	}
+
+	~CRawMouseLookListener()
+	{
+		Enable(false);
+	}
+
+	void Enable(bool bEnable)
+	{
+		if (bEnable == m_bEnabled || !gEnv->pInput)
+			return;
+
+		if (bEnable)
+		{
+			gEnv->pInput->AddEventListener(this);
+		}
+		else
+		{
+			gEnv->pInput->RemoveEventListener(this);
+		}
+		m_bEnabled = bEnable;
+	}
+
+	bool IsEnabled() const { return m_bEnabled; }
+
+	// IInputEventListener
+	virtual bool OnInputEvent(const SInputEvent& event) override;
+	// ~IInputEventListener
+
+private:
+	CPlayerComponent& m_player;
+	bool m_bEnabled = false;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstring>
+
+#include <CryInput/IInput.h>
+#include <IActionMapManager.h>
+
+// Every input action a player reacts to
+enum class EPlayerInputAction : uint8
+{
+	MoveForward,
+	MoveBack,
+	MoveLeft,
+	MoveRight,
+	Yaw,
+	Pitch,
+	Sprint,
+	Jump,
+	Crouch,
+	YawStick,   // Stick deflections, turn at pl_stickLookRate instead of by the reported motion
+	PitchStick,
+
+	Count
+};
+
+// Devices a player action can be bound on, each action holds one key per device
+enum class EPlayerInputDevice : uint8
+{
+	KeyboardMouse,
+	Xbox,
+	Orbis,
+	Oculus,
+
+	Count
+};
+
+namespace PlayerInput
+{
+	static constexpr size_t ActionCount = static_cast<size_t>(EPlayerInputAction::Count);
+	static constexpr size_t DeviceCount = static_cast<size_t>(EPlayerInputDevice::Count);
+
+	// Action map group every player action is registered in
+	static constexpr const char* ActionGroup = "player";
+
+	// Action names as registered on the input component
+	static constexpr const char* s_actionNames[ActionCount] =
+	{
+		"moveforward",
+		"moveback",
+		"moveleft",
+		"moveright",
+		"yaw",
+		"pitch",
+		"sprint",
+		"jump",
+		"crouch",
+		"yawstick",
+		"pitchstick"
+	};
+
+	// Names used for trace events and allocation tags
+	static constexpr const char* s_actionTraceNames[ActionCount] =
+	{
+		"Input.moveforward",
+		"Input.moveback",
+		"Input.moveleft",
+		"Input.moveright",
+		"Input.yaw",
+		"Input.pitch",
+		"Input.sprint",
+		"Input.jump",
+		"Input.crouch",
+		"Input.yawstick",
+		"Input.pitchstick"
+	};
+
+	inline const char* GetActionName(EPlayerInputAction action)
+	{
+		return action < EPlayerInputAction::Count ? s_actionNames[static_cast<size_t>(action)] : "";
+	}
+
+	inline const char* GetActionTraceName(EPlayerInputAction action)
+	{
+		return action < EPlayerInputAction::Count ? s_actionTraceNames[static_cast<size_t>(action)] : "Input.unknown";
+	}
+
+	// Mouse look, reported as motion since the last event
+	inline bool IsLookAction(EPlayerInputAction action)
+	{
+		return action == EPlayerInputAction::Yaw || action == EPlayerInputAction::Pitch;
+	}
+
+	// Returns EPlayerInputAction::Count if the name is not a known action
+	inline EPlayerInputAction FindAction(const char* szName)
+	{
+		for (size_t i = 0; i < ActionCount; ++i)
+		{
+			if (strcmp(s_actionNames[i], szName) == 0)
+				return static_cast<EPlayerInputAction>(i);
+		}
+		return EPlayerInputAction::Count;
+	}
+
+	// Key ids are grouped per device, returns EPlayerInputDevice::Count for keys no binding device covers
+	inline EPlayerInputDevice GetKeyDevice(EKeyId keyId)
+	{
+		if (keyId < KI_XINPUT_BASE)
+			return EPlayerInputDevice::KeyboardMouse;
+		if (keyId < KI_ORBIS_BASE)
+			return EPlayerInputDevice::Xbox;
+		if (keyId < KI_MOTION_BASE)
+			return EPlayerInputDevice::Orbis;
+		if (keyId < eKI_Motion_OculusTouch_NUM_SYMBOLS)
+			return EPlayerInputDevice::Oculus;
+		return EPlayerInputDevice::Count;
+	}
+
+	inline EActionInputDevice GetActionInputDevice(EPlayerInputDevice device)
+	{
+		switch (device)
+		{
+		case EPlayerInputDevice::KeyboardMouse: return eAID_KeyboardMouse;
+		case EPlayerInputDevice::Xbox:          return eAID_XboxPad;
+		case EPlayerInputDevice::Orbis:         return eAID_PS4Pad;
+		case EPlayerInputDevice::Oculus:        return eAID_OculusTouch;
+		default:                                return eAID_Unknown;
+		}
+	}
+}
@@ -0,0 +1,155 @@
+#include "StdAfx.h"
+#include "AllocationTracker.h"
+
+#include <CrySystem/IConsole.h>
+
+CPlayerAllocationTracker& CPlayerAllocationTracker::Get()
+{
+	static CPlayerAllocationTracker s_instance;
+	return s_instance;
+}
+
+CPlayerAllocationTracker::SCounters CPlayerAllocationTracker::SampleModuleCounters()
+{
+	CryModuleMemoryInfo memoryInfo;
+	CryModuleGetMemoryInfo(&memoryInfo);
+
+	SCounters counters;
+	counters.allocations = static_cast<uint64>(max(memoryInfo.num_allocations, 0));
+	counters.allocatedBytes = memoryInfo.allocated;
+	counters.liveBytes = memoryInfo.allocated > memoryInfo.freed ? memoryInfo.allocated - memoryInfo.freed : 0;
+
+	static bool s_bCheckedAllocationCount = false;
+	if (!s_bCheckedAllocationCount && counters.allocatedBytes > 0)
+	{
+		s_bCheckedAllocationCount = true;
+		if (counters.allocations == 0)
+		{
+			CryLogAlways("[Alloc] The module allocator does not count allocations, frames that allocate are counted once.");
+		}
+	}
+	return counters;
+}
+
+uint64 CPlayerAllocationTracker::GetAllocationsBetween(const SCounters& begin, const SCounters& end)
+{
+	const uint64 allocations = end.allocations > begin.allocations ? end.allocations - begin.allocations : 0;
+	return max(allocations, static_cast<uint64>(end.allocatedBytes > begin.allocatedBytes ? 1 : 0));
+}
+
+void CPlayerAllocationTracker::AddSample(const char* szTag, const SCounters& begin, const SCounters& end)
+{
+	// Tags are string literals, so comparing pointers is enough to find the slot
+	STagStats* pStats = nullptr;
+	for (uint32 i = 0; i < m_tagCount; ++i)
+	{
+		if (m_tags[i].szTag == szTag)
+		{
+			pStats = &m_tags[i];
+			break;
+		}
+	}
+
+	if (!pStats)
+	{
+		if (m_tagCount == MaxTags)
+			return;
+
+		pStats = &m_tags[m_tagCount++];
+		pStats->szTag = szTag;
+	}
+
+	++pStats->calls;
+	pStats->allocations += GetAllocationsBetween(begin, end);
+	pStats->bytes += end.allocatedBytes > begin.allocatedBytes ? end.allocatedBytes - begin.allocatedBytes : 0;
+}
+
+void CPlayerAllocationTracker::ResetTags()
+{
+	m_tags.fill(STagStats());
+	m_tagCount = 0;
+}
+
+void CPlayerAllocationTracker::LogTags() const
+{
+#if defined(PLAYER_ALLOCATION_TRACKING)
+	CryLogAlways("[Alloc] %-32s %10s %12s %12s", "Call site", "Calls", "Allocations", "Bytes");
+	for (uint32 i = 0; i < m_tagCount; ++i)
+	{
+		const STagStats& stats = m_tags[i];
+		CryLogAlways("[Alloc] %-32s %10llu %12llu %12llu", stats.szTag,
+			static_cast<unsigned long long>(stats.calls),
+			static_cast<unsigned long long>(stats.allocations),
+			static_cast<unsigned long long>(stats.bytes));
+	}
+#else
+	CryLogAlways("[Alloc] Call-site tagging is disabled, build with PLAYER_ALLOCATION_TRACKING to enable it.");
+#endif
+}
+
+void CPlayerAllocationTracker::BeginCheck(uint32 warmupFrames, uint32 frameCount)
+{
+	ResetTags();
+
+	m_warmupFramesLeft = warmupFrames;
+	m_checkFramesLeft = max(frameCount, 1u);
+	m_checkedFrames = 0;
+	m_failedFrames = 0;
+	m_checkAllocations = 0;
+}
+
+void CPlayerAllocationTracker::OnFrameEnd(uint32 frameAllocations)
+{
+	if (m_checkFramesLeft == 0)
+		return;
+
+	if (m_warmupFramesLeft > 0)
+	{
+		// Let first-use initialization settle before expecting a flat heap
+		if (--m_warmupFramesLeft == 0)
+		{
+			ResetTags();
+		}
+		return;
+	}
+
+	++m_checkedFrames;
+	if (frameAllocations > 0)
+	{
+		++m_failedFrames;
+		m_checkAllocations += frameAllocations;
+	}
+
+	if (--m_checkFramesLeft == 0)
+	{
+		if (m_failedFrames == 0)
+		{
+			CryLogAlways("[AllocCheck] PASSED: %u steady-state frames without heap allocations.", m_checkedFrames);
+		}
+		else
+		{
+			CryLogAlways("[AllocCheck] FAILED: %u of %u steady-state frames allocated (%llu allocations).",
+				m_failedFrames, m_checkedFrames, static_cast<unsigned long long>(m_checkAllocations));
+			LogTags();
+		}
+	}
+}
+
+void CPlayerAllocationTracker::CmdLog(IConsoleCmdArgs* pArgs)
+{
+	Get().LogTags();
+}
+
+void CPlayerAllocationTracker::CmdReset(IConsoleCmdArgs* pArgs)
+{
+	Get().ResetTags();
+}
+
+void CPlayerAllocationTracker::CmdCheck(IConsoleCmdArgs* pArgs)
+{
+	const uint32 frameCount = pArgs->GetArgCount() > 1 ? static_cast<uint32>(max(atoi(pArgs->GetArg(1)), 1)) : 300;
+	const uint32 warmupFrames = pArgs->GetArgCount() > 2 ? static_cast<uint32>(max(atoi(pArgs->GetArg(2)), 0)) : 30;
+
+	Get().BeginCheck(warmupFrames, frameCount);
+	CryLogAlways("[AllocCheck] Checking %u frames after %u warmup frames.", frameCount, warmupFrames);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+
+struct IConsoleCmdArgs;
+
+////////////////////////////////////////////////////////
+// Tracks heap allocations made by the player plugin.
+// Counts come from the module allocation counters that the
+// CryMemoryManager operator new/delete hooks maintain.
+// Per call-site tags are only compiled in when the
+// PLAYER_ALLOCATION_TRACKING build option is enabled, the
+// steady-state check (pl_allocCheck) is always available.
+////////////////////////////////////////////////////////
+class CPlayerAllocationTracker
+{
+public:
+	// allocations and allocatedBytes only ever grow, liveBytes is what is still allocated (allocated - freed)
+	struct SCounters
+	{
+		uint64 allocations = 0;
+		uint64 allocatedBytes = 0;
+		uint64 liveBytes = 0;
+	};
+
+	struct STagStats
+	{
+		const char* szTag = nullptr; // Must point to a string literal
+		uint64 calls = 0;
+		uint64 allocations = 0;
+		uint64 bytes = 0;
+	};
+
+	static CPlayerAllocationTracker& Get();
+	static SCounters SampleModuleCounters();
+	// Allocations between two samples. Counts at least one when the allocated bytes grew, in case the
+	// allocator does not maintain num_allocations.
+	static uint64 GetAllocationsBetween(const SCounters& begin, const SCounters& end);
+
+	void AddSample(const char* szTag, const SCounters& begin, const SCounters& end);
+	void ResetTags();
+	void LogTags() const;
+
+	// Arms the steady-state check: after warmupFrames, every one of the next frameCount frames must not allocate
+	void BeginCheck(uint32 warmupFrames, uint32 frameCount);
+	void OnFrameEnd(uint32 frameAllocations);
+	bool IsChecking() const { return m_checkFramesLeft > 0; }
+
+	// Console commands
+	static void CmdLog(IConsoleCmdArgs* pArgs);
+	static void CmdReset(IConsoleCmdArgs* pArgs);
+	static void CmdCheck(IConsoleCmdArgs* pArgs);
+
+private:
+	static constexpr uint32 MaxTags = 64;
+
+	std::array<STagStats, MaxTags> m_tags;
+	uint32 m_tagCount = 0;
+
+	uint32 m_warmupFramesLeft = 0;
+	uint32 m_checkFramesLeft = 0;
+	uint32 m_checkedFrames = 0;
+	uint32 m_failedFrames = 0;
+	uint64 m_checkAllocations = 0;
+};
+
+#if defined(PLAYER_ALLOCATION_TRACKING)
+
+// Attributes the allocations made during its lifetime to a call-site tag
+class CPlayerAllocationScope
+{
+public:
+	explicit CPlayerAllocationScope(const char* szTag)
+		: m_szTag(szTag)
+		, m_begin(CPlayerAllocationTracker::SampleModuleCounters())
+	{
+	}
+
+	~CPlayerAllocationScope()
+	{
+		CPlayerAllocationTracker::Get().AddSample(m_szTag, m_begin, CPlayerAllocationTracker::SampleModuleCounters());
+	}
+
+private:
+	const char* m_szTag;
+	CPlayerAllocationTracker::SCounters m_begin;
+};
+
+#define PLAYER_ALLOC_SCOPE(tag) CPlayerAllocationScope playerAllocationScope(tag)
+
+#else
+
+#define PLAYER_ALLOC_SCOPE(tag) ((void)0)
+
+#endif
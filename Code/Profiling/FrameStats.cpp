@@ -0,0 +1,106 @@
+#include "StdAfx.h"
+#include "FrameStats.h"
+#include "Components/ConsoleVariables.h"
+
+#include <CrySystem/IConsole.h>
+
+CPlayerFrameStats::CPlayerFrameStats()
+	: m_lastHeapSample(CPlayerAllocationTracker::SampleModuleCounters())
+{
+	// Sampled up front, otherwise the first frame reports every allocation since module load
+}
+
+CPlayerFrameStats& CPlayerFrameStats::Get()
+{
+	static CPlayerFrameStats s_instance;
+	return s_instance;
+}
+
+const char* CPlayerFrameStats::GetStatName(EPlayerStat stat)
+{
+	switch (stat)
+	{
+	case EPlayerStat::QueueFragment:         return "QueueFragment";
+	case EPlayerStat::Raycast:               return "Raycast";
+	case EPlayerStat::PrimitiveIntersection: return "PrimitiveIntersection";
+	case EPlayerStat::SetVelocity:           return "SetVelocity";
+	case EPlayerStat::SetRotation:           return "SetRotation";
+	case EPlayerStat::SetTransformMatrix:    return "SetTransformMatrix";
+	case EPlayerStat::AudioTrigger:          return "AudioTrigger";
+	case EPlayerStat::LogLine:               return "LogLine";
+	case EPlayerStat::HeapAllocation:        return "HeapAllocation";
+	case EPlayerStat::InputQueueOverflow:    return "InputQueueOverflow";
+	}
+	return "Unknown";
+}
+
+uint32 CPlayerFrameStats::SampleHeapAllocations()
+{
+	// Allocation counters of this module, the difference to the previous sample is this frame's allocations
+	const CPlayerAllocationTracker::SCounters sample = CPlayerAllocationTracker::SampleModuleCounters();
+	const uint64 delta = CPlayerAllocationTracker::GetAllocationsBetween(m_lastHeapSample, sample);
+	m_lastHeapSample = sample;
+	return static_cast<uint32>(min(delta, static_cast<uint64>(UINT32_MAX)));
+}
+
+void CPlayerFrameStats::OnFrameEnd(float frameTime)
+{
+	Increment(EPlayerStat::HeapAllocation, SampleHeapAllocations());
+
+	for (size_t i = 0; i < StatCount; ++i)
+	{
+		const uint32 value = m_current[i].exchange(0, std::memory_order_relaxed);
+		m_lastFrame[i] = value;
+		m_peak[i] = max(m_peak[i], value);
+		m_total[i] += value;
+	}
+	++m_frameCount;
+
+	const float logInterval = CConsoleVariables::Get().pl_statsLogInterval;
+	if (logInterval > 0.f)
+	{
+		m_timeSinceLog += frameTime;
+		if (m_timeSinceLog >= logInterval)
+		{
+			m_timeSinceLog = 0.f;
+			Log();
+		}
+	}
+}
+
+void CPlayerFrameStats::Reset()
+{
+	for (std::atomic<uint32>& value : m_current)
+	{
+		value.store(0, std::memory_order_relaxed);
+	}
+	m_lastFrame.fill(0);
+	m_peak.fill(0);
+	m_total.fill(0);
+	m_frameCount = 0;
+	m_timeSinceLog = 0.f;
+	SampleHeapAllocations();
+}
+
+void CPlayerFrameStats::Log() const
+{
+	CryLogAlways("[Stats] Player plugin work over %llu frames", static_cast<unsigned long long>(m_frameCount));
+	CryLogAlways("[Stats] %-22s %10s %10s %10s", "Counter", "Last", "Avg", "Peak");
+
+	for (size_t i = 0; i < StatCount; ++i)
+	{
+		const double average = m_frameCount > 0 ? static_cast<double>(m_total[i]) / static_cast<double>(m_frameCount) : 0.0;
+		CryLogAlways("[Stats] %-22s %10u %10.2f %10u", GetStatName(static_cast<EPlayerStat>(i)), m_lastFrame[i], average, m_peak[i]);
+	}
+}
+
+void CPlayerFrameStats::CmdLog(IConsoleCmdArgs* pArgs)
+{
+	Get().Log();
+}
+
+void CPlayerFrameStats::CmdReset(IConsoleCmdArgs* pArgs)
+{
+	Get().Reset();
+	CryLogAlways("[Stats] Player plugin counters reset.");
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "Profiling/AllocationTracker.h"
+
+struct IConsoleCmdArgs;
+
+enum class EPlayerStat : uint8
+{
+	QueueFragment,
+	Raycast,
+	PrimitiveIntersection,
+	SetVelocity,
+	SetRotation,
+	SetTransformMatrix,
+	AudioTrigger,
+	LogLine,
+	HeapAllocation,
+	InputQueueOverflow,
+
+	Count
+};
+
+////////////////////////////////////////////////////////
+// Cheap always-on counters for the work the player plugin
+// causes each frame. Rolled over once per frame by the plugin.
+////////////////////////////////////////////////////////
+class CPlayerFrameStats
+{
+public:
+	static constexpr size_t StatCount = static_cast<size_t>(EPlayerStat::Count);
+
+	CPlayerFrameStats();
+
+	static CPlayerFrameStats& Get();
+	static const char* GetStatName(EPlayerStat stat);
+
+	void Increment(EPlayerStat stat, uint32 count = 1)
+	{
+		m_current[static_cast<size_t>(stat)].fetch_add(count, std::memory_order_relaxed);
+	}
+
+	// Snapshots the current frame and handles the periodic log
+	void OnFrameEnd(float frameTime);
+	void Reset();
+	void Log() const;
+
+	uint32 GetLastFrame(EPlayerStat stat) const { return m_lastFrame[static_cast<size_t>(stat)]; }
+
+	// Console commands
+	static void CmdLog(IConsoleCmdArgs* pArgs);
+	static void CmdReset(IConsoleCmdArgs* pArgs);
+
+private:
+	uint32 SampleHeapAllocations();
+
+	std::array<std::atomic<uint32>, StatCount> m_current{};
+	std::array<uint32, StatCount> m_lastFrame{};
+	std::array<uint32, StatCount> m_peak{};
+	std::array<uint64, StatCount> m_total{};
+	uint64 m_frameCount = 0;
+	CPlayerAllocationTracker::SCounters m_lastHeapSample;
+	float m_timeSinceLog = 0.f;
+};
+
+#define PLAYER_STAT_INC(stat) CPlayerFrameStats::Get().Increment(EPlayerStat::stat)
+
+// Logs through CryLogAlways and counts the line
+#define PLAYER_LOG(...)                 \
+	do                                  \
+	{                                   \
+		PLAYER_STAT_INC(LogLine);       \
+		CryLogAlways(__VA_ARGS__);      \
+	} while (false)
@@ -0,0 +1,112 @@
+#include "StdAfx.h"
+#include "LatencyStats.h"
+
+#include <CrySystem/IConsole.h>
+
+CPlayerLatencyStats& CPlayerLatencyStats::Get()
+{
+	static CPlayerLatencyStats s_instance;
+	return s_instance;
+}
+
+const char* CPlayerLatencyStats::GetSinkName(EPlayerLatencySink sink)
+{
+	switch (sink)
+	{
+	case EPlayerLatencySink::CameraTransform: return "SetTransformMatrix";
+	case EPlayerLatencySink::Rotation:        return "SetRotation";
+	case EPlayerLatencySink::Velocity:        return "SetVelocity";
+	}
+	return "Unknown";
+}
+
+void CPlayerLatencyStats::AddSample(EPlayerLatencySink sink, int64 inputTicks, int64 writeTicks)
+{
+	const int64 ticks = max(writeTicks - inputTicks, static_cast<int64>(0));
+	const uint64 microSeconds = static_cast<uint64>(ticks * 1000000 / max(CryGetTicksPerSec(), static_cast<int64>(1)));
+
+	size_t bucket = 0;
+	while (bucket + 1 < BucketCount && microSeconds >= (static_cast<uint64>(2) << bucket))
+	{
+		++bucket;
+	}
+
+	SHistogram& histogram = m_histograms[static_cast<size_t>(sink)];
+	++histogram.buckets[bucket];
+	++histogram.sampleCount;
+	histogram.totalMicroSeconds += microSeconds;
+	histogram.maxMicroSeconds = max(histogram.maxMicroSeconds, microSeconds);
+}
+
+void CPlayerLatencyStats::Reset()
+{
+	m_histograms.fill(SHistogram());
+}
+
+uint64 CPlayerLatencyStats::GetPercentileUpperBound(const SHistogram& histogram, float percentile)
+{
+	const uint64 target = static_cast<uint64>(ceilf(static_cast<float>(histogram.sampleCount) * percentile));
+
+	uint64 accumulated = 0;
+	for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+	{
+		accumulated += histogram.buckets[bucket];
+		if (accumulated >= target && bucket + 1 < BucketCount)
+			return static_cast<uint64>(2) << bucket;
+	}
+
+	// The last bucket has no upper bound of its own
+	return histogram.maxMicroSeconds;
+}
+
+void CPlayerLatencyStats::Log() const
+{
+	for (size_t sink = 0; sink < SinkCount; ++sink)
+	{
+		const SHistogram& histogram = m_histograms[sink];
+		const char* szSinkName = GetSinkName(static_cast<EPlayerLatencySink>(sink));
+
+		if (histogram.sampleCount == 0)
+		{
+			CryLogAlways("[Latency] Input -> %s: no samples", szSinkName);
+			continue;
+		}
+
+		CryLogAlways("[Latency] Input -> %s: %llu samples, avg %.3f ms, p50 < %.3f ms, p99 < %.3f ms, max %.3f ms", szSinkName,
+			static_cast<unsigned long long>(histogram.sampleCount),
+			static_cast<double>(histogram.totalMicroSeconds) / static_cast<double>(histogram.sampleCount) / 1000.0,
+			static_cast<double>(GetPercentileUpperBound(histogram, 0.5f)) / 1000.0,
+			static_cast<double>(GetPercentileUpperBound(histogram, 0.99f)) / 1000.0,
+			static_cast<double>(histogram.maxMicroSeconds) / 1000.0);
+
+		for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+		{
+			if (histogram.buckets[bucket] == 0)
+				continue;
+
+			const double percentage = 100.0 * static_cast<double>(histogram.buckets[bucket]) / static_cast<double>(histogram.sampleCount);
+			if (bucket + 1 < BucketCount)
+			{
+				CryLogAlways("[Latency]   <  %9.3f ms %8u (%5.1f%%)",
+					static_cast<double>(static_cast<uint64>(2) << bucket) / 1000.0, histogram.buckets[bucket], percentage);
+			}
+			else
+			{
+				// Overflow bucket, everything from its lower bound up
+				CryLogAlways("[Latency]   >= %9.3f ms %8u (%5.1f%%)",
+					static_cast<double>(static_cast<uint64>(1) << bucket) / 1000.0, histogram.buckets[bucket], percentage);
+			}
+		}
+	}
+}
+
+void CPlayerLatencyStats::CmdLog(IConsoleCmdArgs* pArgs)
+{
+	Get().Log();
+}
+
+void CPlayerLatencyStats::CmdReset(IConsoleCmdArgs* pArgs)
+{
+	Get().Reset();
+	CryLogAlways("[Latency] Histograms reset.");
+}
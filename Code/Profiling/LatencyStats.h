@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+
+struct IConsoleCmdArgs;
+
+// The calls through which input lands on the player
+enum class EPlayerLatencySink : uint8
+{
+	CameraTransform, // SetTransformMatrix on the camera, carries pitch
+	Rotation,        // SetRotation on the entity, carries yaw
+	Velocity,        // SetVelocity on the character controller, carries movement keys
+
+	Count
+};
+
+////////////////////////////////////////////////////////
+// Histograms of the time between an input event reaching
+// CPlayerComponent and the resulting change being written.
+////////////////////////////////////////////////////////
+class CPlayerLatencyStats
+{
+public:
+	static constexpr size_t SinkCount = static_cast<size_t>(EPlayerLatencySink::Count);
+
+	// Bucket i holds samples below 2^(i + 1) microseconds, the last bucket everything from 2^(BucketCount - 1) up
+	static constexpr size_t BucketCount = 20;
+
+	static CPlayerLatencyStats& Get();
+	static const char* GetSinkName(EPlayerLatencySink sink);
+
+	void AddSample(EPlayerLatencySink sink, int64 inputTicks, int64 writeTicks);
+	void Reset();
+	void Log() const;
+
+	// Console commands
+	static void CmdLog(IConsoleCmdArgs* pArgs);
+	static void CmdReset(IConsoleCmdArgs* pArgs);
+
+private:
+	struct SHistogram
+	{
+		std::array<uint32, BucketCount> buckets{};
+		uint64 sampleCount = 0;
+		uint64 totalMicroSeconds = 0;
+		uint64 maxMicroSeconds = 0;
+	};
+
+	static uint64 GetPercentileUpperBound(const SHistogram& histogram, float percentile);
+
+	std::array<SHistogram, SinkCount> m_histograms;
+};
@@ -0,0 +1,58 @@
+#include "StdAfx.h"
+#include "MemoryStats.h"
+#include "Components/Player.h"
+#include "Components/PlayerRegistry.h"
+
+#include <CrySystem/IConsole.h>
+
+const char* CPlayerMemoryStats::GetCategoryName(EPlayerMemoryCategory category)
+{
+	switch (category)
+	{
+	case EPlayerMemoryCategory::Component:      return "Component";
+	case EPlayerMemoryCategory::InputBuffers:   return "InputBuffers";
+	case EPlayerMemoryCategory::InputCallbacks: return "InputCallbacks";
+	case EPlayerMemoryCategory::SurfaceTypes:   return "SurfaceTypes";
+	case EPlayerMemoryCategory::AnimationNames: return "AnimationNames";
+	case EPlayerMemoryCategory::Archetypes:     return "Archetypes";
+	}
+	return "Unknown";
+}
+
+size_t CPlayerMemoryStats::GetTotalBytes() const
+{
+	size_t total = 0;
+	for (size_t bytes : m_bytes)
+	{
+		total += bytes;
+	}
+	return total;
+}
+
+void CPlayerMemoryStats::Log(uint32 playerCount) const
+{
+	const size_t totalBytes = GetTotalBytes();
+	CryLogAlways("[Memory] %u players, %llu bytes total, %llu bytes per player", playerCount,
+		static_cast<unsigned long long>(totalBytes),
+		static_cast<unsigned long long>(playerCount > 0 ? totalBytes / playerCount : 0));
+	CryLogAlways("[Memory] %-16s %12s %12s", "Category", "Total", "Per player");
+
+	for (size_t i = 0; i < CategoryCount; ++i)
+	{
+		CryLogAlways("[Memory] %-16s %12llu %12llu", GetCategoryName(static_cast<EPlayerMemoryCategory>(i)),
+			static_cast<unsigned long long>(m_bytes[i]),
+			static_cast<unsigned long long>(playerCount > 0 ? m_bytes[i] / playerCount : 0));
+	}
+}
+
+void CPlayerMemoryStats::CmdLog(IConsoleCmdArgs* pArgs)
+{
+	const std::vector<CPlayerComponent*>& players = CPlayerRegistry::Get().GetPlayers();
+
+	CPlayerMemoryStats stats;
+	for (const CPlayerComponent* pPlayer : players)
+	{
+		pPlayer->AddMemoryUsage(stats);
+	}
+	stats.Log(static_cast<uint32>(players.size()));
+}
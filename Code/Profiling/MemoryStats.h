@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <unordered_set>
+
+struct IConsoleCmdArgs;
+
+enum class EPlayerMemoryCategory : uint8
+{
+	Component,      // The component object itself
+	InputBuffers,   // Input event queue, its own allocation, and the binding table of the shared action map
+	InputCallbacks, // Input component the actions are registered on and the raw mouse listener, without the engine's internal action storage
+	SurfaceTypes,   // Surface type to audio trigger map
+	AnimationNames, // Fragment names and the player tag, shared between players where possible
+	Archetypes,     // Interned movement, camera and animation settings
+
+	Count
+};
+
+////////////////////////////////////////////////////////
+// Bytes owned by players, by category. Allocations are
+// counted once by their address, so strings shared by
+// several players are not counted twice.
+////////////////////////////////////////////////////////
+class CPlayerMemoryStats
+{
+public:
+	static constexpr size_t CategoryCount = static_cast<size_t>(EPlayerMemoryCategory::Count);
+
+	static const char* GetCategoryName(EPlayerMemoryCategory category);
+
+	void Add(EPlayerMemoryCategory category, const void* pId, size_t size)
+	{
+		if (m_seen.insert(pId).second)
+		{
+			m_bytes[static_cast<size_t>(category)] += size;
+		}
+	}
+
+	size_t GetBytes(EPlayerMemoryCategory category) const { return m_bytes[static_cast<size_t>(category)]; }
+	size_t GetTotalBytes() const;
+
+	void Log(uint32 playerCount) const;
+
+	// Console command
+	static void CmdLog(IConsoleCmdArgs* pArgs);
+
+private:
+	std::array<size_t, CategoryCount> m_bytes{};
+	std::unordered_set<const void*> m_seen;
+};
@@ -0,0 +1,169 @@
+#include "StdAfx.h"
+#include "NodeProfiler.h"
+#include "Components/ConsoleVariables.h"
+#include "Profiling/TraceRecorder.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <CrySystem/IConsole.h>
+
+CPlayerNodeProfileScope* CPlayerNodeProfileScope::s_pActive = nullptr;
+
+namespace
+{
+	double TicksToMilliSeconds(int64 ticks)
+	{
+		return static_cast<double>(ticks) * 1000.0 / static_cast<double>(max(CryGetTicksPerSec(), static_cast<int64>(1)));
+	}
+
+	void LogCounters(const char* szName, const CPlayerNodeProfiler::SCounters& counters)
+	{
+		const double average = counters.activations > 0 ? TicksToMilliSeconds(counters.totalTicks) / static_cast<double>(counters.activations) : 0.0;
+		CryLogAlways("[NodeProfile] %-40s %10llu %10llu %10llu %10.3f %10.4f %10.3f", szName,
+			static_cast<unsigned long long>(counters.activations),
+			static_cast<unsigned long long>(counters.failures),
+			static_cast<unsigned long long>(counters.entityLookups),
+			TicksToMilliSeconds(counters.totalTicks), average, TicksToMilliSeconds(counters.maxTicks));
+	}
+}
+
+void CPlayerNodeProfiler::SCounters::Add(int64 ticks, uint32 failureCount, uint32 entityLookupCount)
+{
+	++activations;
+	failures += failureCount;
+	entityLookups += entityLookupCount;
+	totalTicks += ticks;
+	maxTicks = max(maxTicks, ticks);
+}
+
+CPlayerNodeProfiler& CPlayerNodeProfiler::Get()
+{
+	static CPlayerNodeProfiler s_instance;
+	return s_instance;
+}
+
+const char* CPlayerNodeProfiler::GetNodeName(EPlayerFlowNode node)
+{
+	// Also used as trace event names, so these must stay literals
+	switch (node)
+	{
+	case EPlayerFlowNode::ChangeInputBinding:          return "FlowNode.ChangeInputBind";
+	case EPlayerFlowNode::ChangeInputBindingBatch:     return "FlowNode.ChangeInputBindBatch";
+	case EPlayerFlowNode::TriggerCustomAnimation:      return "FlowNode.PlayCustomAnimation";
+	case EPlayerFlowNode::TriggerCustomAnimationBatch: return "FlowNode.PlayCustomAnimationBatch";
+	}
+	return "FlowNode.Unknown";
+}
+
+bool CPlayerNodeProfiler::IsEnabled()
+{
+	return CConsoleVariables::Get().pl_nodeProfile != 0;
+}
+
+void CPlayerNodeProfiler::AddActivation(EPlayerFlowNode node, const IFlowNode::SActivationInfo& actInfo, int64 ticks, uint32 failureCount, uint32 entityLookupCount)
+{
+	m_nodes[static_cast<size_t>(node)].Add(ticks, failureCount, entityLookupCount);
+
+	if (!actInfo.pGraph)
+		return;
+
+	const TFlowGraphId graphId = actInfo.pGraph->GetGraphId();
+	const uint64 key = (static_cast<uint64>(graphId) << 32) | actInfo.myID;
+	auto it = m_instances.find(key);
+	if (it == m_instances.end())
+	{
+		SInstance instance;
+		instance.node = node;
+		instance.graphId = graphId;
+		instance.nodeId = actInfo.myID;
+		instance.graphName = actInfo.pGraph->GetDebugName();
+		it = m_instances.emplace(key, std::move(instance)).first;
+	}
+	it->second.counters.Add(ticks, failureCount, entityLookupCount);
+}
+
+void CPlayerNodeProfiler::Reset()
+{
+	m_nodes.fill(SCounters());
+	m_instances.clear();
+}
+
+void CPlayerNodeProfiler::Log(uint32 maxInstances) const
+{
+	if (!IsEnabled())
+	{
+		CryLogAlways("[NodeProfile] pl_nodeProfile is 0, no activations are being collected.");
+	}
+
+	CryLogAlways("[NodeProfile] %-40s %10s %10s %10s %10s %10s %10s", "Node", "Calls", "Failures", "Lookups", "Total ms", "Avg ms", "Max ms");
+	for (size_t i = 0; i < NodeCount; ++i)
+	{
+		LogCounters(GetNodeName(static_cast<EPlayerFlowNode>(i)), m_nodes[i]);
+	}
+
+	if (m_instances.empty() || maxInstances == 0)
+		return;
+
+	std::vector<const SInstance*> instances;
+	instances.reserve(m_instances.size());
+	for (const auto& instance : m_instances)
+	{
+		instances.push_back(&instance.second);
+	}
+	std::sort(instances.begin(), instances.end(), [](const SInstance* pLeft, const SInstance* pRight)
+	{
+		return pLeft->counters.totalTicks > pRight->counters.totalTicks;
+	});
+
+	const size_t count = min(instances.size(), static_cast<size_t>(maxInstances));
+	CryLogAlways("[NodeProfile] Top %u of %u instances by total time:", static_cast<uint32>(count), static_cast<uint32>(instances.size()));
+	for (size_t i = 0; i < count; ++i)
+	{
+		const SInstance& instance = *instances[i];
+		string name;
+		name.Format("%s #%u (%s)", instance.graphName.c_str(), static_cast<uint32>(instance.nodeId), GetNodeName(instance.node));
+		LogCounters(name.c_str(), instance.counters);
+	}
+}
+
+void CPlayerNodeProfiler::CmdLog(IConsoleCmdArgs* pArgs)
+{
+	const uint32 maxInstances = pArgs->GetArgCount() > 1 ? static_cast<uint32>(max(atoi(pArgs->GetArg(1)), 0)) : 10;
+	Get().Log(maxInstances);
+}
+
+void CPlayerNodeProfiler::CmdReset(IConsoleCmdArgs* pArgs)
+{
+	Get().Reset();
+	CryLogAlways("[NodeProfile] Counters reset.");
+}
+
+CPlayerNodeProfileScope::CPlayerNodeProfileScope(EPlayerFlowNode node, const IFlowNode::SActivationInfo* pActInfo)
+	: m_pActInfo(CPlayerNodeProfiler::IsEnabled() ? pActInfo : nullptr)
+	, m_pPrevious(s_pActive)
+	, m_startTicks(0)
+	, m_node(node)
+	, m_traceSession(CPlayerTraceRecorder::Get().IsRecording() ? CPlayerTraceRecorder::Get().RecordBegin(CPlayerNodeProfiler::GetNodeName(node)) : 0)
+{
+	s_pActive = this;
+
+	if (m_pActInfo)
+	{
+		m_startTicks = CryGetTicks();
+	}
+}
+
+CPlayerNodeProfileScope::~CPlayerNodeProfileScope()
+{
+	if (m_pActInfo)
+	{
+		CPlayerNodeProfiler::Get().AddActivation(m_node, *m_pActInfo, CryGetTicks() - m_startTicks, m_failureCount, m_entityLookupCount);
+	}
+	if (m_traceSession != 0)
+	{
+		CPlayerTraceRecorder::Get().RecordEnd(CPlayerNodeProfiler::GetNodeName(m_node), m_traceSession);
+	}
+
+	s_pActive = m_pPrevious;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+
+#include <CryFlowGraph/IFlowSystem.h>
+
+struct IConsoleCmdArgs;
+
+enum class EPlayerFlowNode : uint8
+{
+	ChangeInputBinding,
+	ChangeInputBindingBatch,
+	TriggerCustomAnimation,
+	TriggerCustomAnimationBatch,
+
+	Count
+};
+
+////////////////////////////////////////////////////////
+// Activation counts and timings of the Player Component
+// flow nodes, per node type and per node instance, to
+// find the graphs behind frame spikes. Only collects
+// while pl_nodeProfile is set.
+////////////////////////////////////////////////////////
+class CPlayerNodeProfiler
+{
+public:
+	static constexpr size_t NodeCount = static_cast<size_t>(EPlayerFlowNode::Count);
+
+	struct SCounters
+	{
+		uint64 activations = 0;
+		uint64 failures = 0;
+		uint64 entityLookups = 0;
+		int64 totalTicks = 0;
+		int64 maxTicks = 0;
+
+		void Add(int64 ticks, uint32 failureCount, uint32 entityLookupCount);
+	};
+
+	static CPlayerNodeProfiler& Get();
+	static const char* GetNodeName(EPlayerFlowNode node);
+	static bool IsEnabled();
+
+	void AddActivation(EPlayerFlowNode node, const IFlowNode::SActivationInfo& actInfo, int64 ticks, uint32 failureCount, uint32 entityLookupCount);
+	void Reset();
+	// Node types first, then the instances that took the most time
+	void Log(uint32 maxInstances) const;
+
+	// Console commands
+	static void CmdLog(IConsoleCmdArgs* pArgs);
+	static void CmdReset(IConsoleCmdArgs* pArgs);
+
+private:
+	struct SInstance
+	{
+		EPlayerFlowNode node;
+		TFlowGraphId graphId;
+		TFlowNodeId nodeId;
+		string graphName; // Copied, the graph may be gone by the time the stats are logged
+		SCounters counters;
+	};
+
+	std::array<SCounters, NodeCount> m_nodes;
+	std::unordered_map<uint64, SInstance> m_instances; // By graph id and node id
+};
+
+// Times one node activation. Flow graphs update on the main thread, so the
+// innermost scope is kept in a static for the entity lookup counter.
+class CPlayerNodeProfileScope
+{
+public:
+	CPlayerNodeProfileScope(EPlayerFlowNode node, const IFlowNode::SActivationInfo* pActInfo);
+	~CPlayerNodeProfileScope();
+
+	void AddFailures(uint32 count = 1) { m_failureCount += count; }
+
+	// Counts a registry or entity system lookup against the active scope, if there is one
+	static void CountEntityLookup()
+	{
+		if (s_pActive)
+		{
+			++s_pActive->m_entityLookupCount;
+		}
+	}
+
+private:
+	const IFlowNode::SActivationInfo* m_pActInfo;
+	CPlayerNodeProfileScope* m_pPrevious;
+	int64 m_startTicks;
+	uint32 m_failureCount = 0;
+	uint32 m_entityLookupCount = 0;
+	EPlayerFlowNode m_node;
+	uint32 m_traceSession; // 0 if the activation is not traced
+
+	static CPlayerNodeProfileScope* s_pActive;
+};
@@ -0,0 +1,177 @@
+#include "StdAfx.h"
+#include "TraceRecorder.h"
+#include "Components/ConsoleVariables.h"
+
+#include <CrySystem/IConsole.h>
+#include <CrySystem/File/ICryPak.h>
+
+CPlayerTraceRecorder& CPlayerTraceRecorder::Get()
+{
+	static CPlayerTraceRecorder s_instance;
+	return s_instance;
+}
+
+bool CPlayerTraceRecorder::Start(uint32 capacity)
+{
+	if (IsRecording())
+		return false;
+
+	// Ends of the previous session are ignored from here on, then wait for writers already inside Record
+	m_session.store(0);
+	while (m_activeWriters.load() > 0)
+	{
+		CryMT::CryYieldThread();
+	}
+
+	m_events.resize(max(capacity, 1u));
+	m_capacity = static_cast<uint32>(m_events.size());
+	m_reservedSlots.store(0);
+	m_writeIndex.store(0);
+	m_droppedEvents.store(0);
+	m_startTicks = CryGetTicks();
+
+	m_session.store(++m_lastSession);
+	m_bRecording.store(true);
+	return true;
+}
+
+void CPlayerTraceRecorder::Stop()
+{
+	m_bRecording.store(false);
+}
+
+bool CPlayerTraceRecorder::Reserve(uint32 slotCount)
+{
+	uint32 reservedSlots = m_reservedSlots.load(std::memory_order_relaxed);
+	do
+	{
+		if (reservedSlots + slotCount > m_capacity)
+		{
+			// Buffer is full, keep what we have rather than wrapping
+			m_droppedEvents.fetch_add(slotCount, std::memory_order_relaxed);
+			m_bRecording.store(false);
+			return false;
+		}
+	}
+	while (!m_reservedSlots.compare_exchange_weak(reservedSlots, reservedSlots + slotCount, std::memory_order_relaxed));
+	return true;
+}
+
+void CPlayerTraceRecorder::Write(const char* szName, EPhase phase, int64 ticks, uint32 id)
+{
+	// Every write was reserved, so the index stays within the buffer
+	SEvent& event = m_events[m_writeIndex.fetch_add(1, std::memory_order_relaxed)];
+	event.szName = szName;
+	event.ticks = ticks;
+	event.threadId = CryGetCurrentThreadId();
+	event.id = id;
+	event.phase = phase;
+}
+
+uint32 CPlayerTraceRecorder::RecordBegin(const char* szName)
+{
+	CWriterScope writerScope(m_activeWriters);
+	const uint32 session = m_session.load();
+	if (session == 0 || !IsRecording() || !Reserve(2))
+		return 0;
+
+	Write(szName, EPhase::Begin, CryGetTicks());
+	return session;
+}
+
+void CPlayerTraceRecorder::RecordEnd(const char* szName, uint32 session)
+{
+	CWriterScope writerScope(m_activeWriters);
+	if (session == 0 || m_session.load() != session)
+		return;
+
+	Write(szName, EPhase::End, CryGetTicks());
+}
+
+void CPlayerTraceRecorder::RecordInstant(const char* szName)
+{
+	CWriterScope writerScope(m_activeWriters);
+	if (m_session.load() == 0 || !IsRecording() || !Reserve(1))
+		return;
+
+	Write(szName, EPhase::Instant, CryGetTicks());
+}
+
+void CPlayerTraceRecorder::RecordAsync(const char* szName, uint32 id, int64 beginTicks, int64 endTicks)
+{
+	CWriterScope writerScope(m_activeWriters);
+	if (m_session.load() == 0 || !IsRecording() || !Reserve(2))
+		return;
+
+	Write(szName, EPhase::AsyncBegin, beginTicks, id);
+	Write(szName, EPhase::AsyncEnd, endTicks, id);
+}
+
+bool CPlayerTraceRecorder::WriteJson(const char* szPath) const
+{
+	FILE* pFile = gEnv->pCryPak->FOpen(szPath, "wt", ICryPak::FLAGS_NEVER_IN_PAK | ICryPak::FOPEN_ONDISK);
+	if (!pFile)
+	{
+		CryLogAlways("[Trace] Failed to open '%s' for writing.", szPath);
+		return false;
+	}
+
+	const uint32 eventCount = min(m_writeIndex.load(std::memory_order_acquire), m_capacity);
+	const double microSecondsPerTick = 1000000.0 / static_cast<double>(CryGetTicksPerSec());
+
+	gEnv->pCryPak->FPrintf(pFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	for (uint32 i = 0; i < eventCount; ++i)
+	{
+		const SEvent& event = m_events[i];
+		const double timestamp = static_cast<double>(event.ticks - m_startTicks) * microSecondsPerTick;
+
+		char szExtra[32] = "";
+		if (event.phase == EPhase::Instant)
+		{
+			cry_strcpy(szExtra, ",\"s\":\"t\"");
+		}
+		else if (event.phase == EPhase::AsyncBegin || event.phase == EPhase::AsyncEnd)
+		{
+			cry_sprintf(szExtra, ",\"id\":%u", event.id);
+		}
+
+		gEnv->pCryPak->FPrintf(pFile, "{\"name\":\"%s\",\"cat\":\"player\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s}%s\n",
+			event.szName,
+			static_cast<char>(event.phase),
+			timestamp,
+			static_cast<uint32>(event.threadId),
+			szExtra,
+			i + 1 < eventCount ? "," : "");
+	}
+	gEnv->pCryPak->FPrintf(pFile, "]}\n");
+	gEnv->pCryPak->FClose(pFile);
+
+	CryLogAlways("[Trace] Wrote %u events to '%s' (%u dropped).", eventCount, szPath, m_droppedEvents.load(std::memory_order_relaxed));
+	return true;
+}
+
+void CPlayerTraceRecorder::CmdStart(IConsoleCmdArgs* pArgs)
+{
+	const uint32 capacity = pArgs->GetArgCount() > 1
+		? static_cast<uint32>(max(atoi(pArgs->GetArg(1)), 1))
+		: static_cast<uint32>(max(CConsoleVariables::Get().pl_traceCapacity, 1));
+
+	if (!Get().Start(capacity))
+	{
+		CryLogAlways("[Trace] A recording is already running, stop it with pl_traceStop first.");
+		return;
+	}
+	CryLogAlways("[Trace] Recording started (capacity %u events).", capacity);
+}
+
+void CPlayerTraceRecorder::CmdStop(IConsoleCmdArgs* pArgs)
+{
+	Get().Stop();
+	CryLogAlways("[Trace] Recording stopped.");
+}
+
+void CPlayerTraceRecorder::CmdDump(IConsoleCmdArgs* pArgs)
+{
+	const char* szPath = pArgs->GetArgCount() > 1 ? pArgs->GetArg(1) : "%USER%/player_trace.json";
+	Get().WriteJson(szPath);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+struct IConsoleCmdArgs;
+
+////////////////////////////////////////////////////////
+// Captures begin/end events from the player plugin into a
+// preallocated buffer and writes them as Chrome trace_event
+// JSON, so a captured spike can be opened in Perfetto or
+// chrome://tracing.
+////////////////////////////////////////////////////////
+class CPlayerTraceRecorder
+{
+public:
+	enum class EPhase : char
+	{
+		Begin = 'B',
+		End = 'E',
+		Instant = 'i',
+		AsyncBegin = 'b', // Async events may overlap the thread's begin/end nesting
+		AsyncEnd = 'e'
+	};
+
+	struct SEvent
+	{
+		const char* szName; // Must point to a string literal, names are not copied
+		int64 ticks;
+		threadID threadId;
+		uint32 id; // Pairs the two ends of an async event, 0 for the other phases
+		EPhase phase;
+	};
+
+	static CPlayerTraceRecorder& Get();
+
+	// Allocates the event buffer up front, recording never allocates. Refused while a recording is running.
+	bool Start(uint32 capacity);
+	void Stop();
+	bool IsRecording() const { return m_bRecording.load(); }
+
+	// A begin reserves the slot of its end, so a full buffer drops whole begin/end pairs instead of leaving
+	// begins unclosed. Returns the session to pass to RecordEnd, 0 if the begin was dropped.
+	uint32 RecordBegin(const char* szName);
+	// Ignored unless the begin was recorded in the same session, ends still land after Stop
+	void RecordEnd(const char* szName, uint32 session);
+	void RecordInstant(const char* szName);
+	// Both ends of an async event at once. Events with the same name need distinct ids (e.g. the EntityId) to overlap.
+	void RecordAsync(const char* szName, uint32 id, int64 beginTicks, int64 endTicks);
+
+	bool WriteJson(const char* szPath) const;
+
+	// Console commands
+	static void CmdStart(IConsoleCmdArgs* pArgs);
+	static void CmdStop(IConsoleCmdArgs* pArgs);
+	static void CmdDump(IConsoleCmdArgs* pArgs);
+
+private:
+	// Counts a thread inside one of the Record functions, Start waits for them before resizing the buffer
+	class CWriterScope
+	{
+	public:
+		explicit CWriterScope(std::atomic<uint32>& writerCount) : m_writerCount(writerCount) { ++m_writerCount; }
+		~CWriterScope() { --m_writerCount; }
+
+	private:
+		std::atomic<uint32>& m_writerCount;
+	};
+
+	bool Reserve(uint32 slotCount);
+	void Write(const char* szName, EPhase phase, int64 ticks, uint32 id = 0);
+
+	std::vector<SEvent> m_events;
+	uint32 m_capacity = 0;
+	std::atomic<uint32> m_reservedSlots{ 0 };
+	std::atomic<uint32> m_writeIndex{ 0 };
+	std::atomic<uint32> m_droppedEvents{ 0 };
+	std::atomic<uint32> m_activeWriters{ 0 };
+	std::atomic<uint32> m_session{ 0 }; // 0 while no buffer is ready to take events
+	uint32 m_lastSession = 0;
+	std::atomic<bool> m_bRecording{ false };
+	int64 m_startTicks = 0;
+};
+
+// Emits a begin event on construction and the matching end event on destruction
+class CPlayerTraceScope
+{
+public:
+	explicit CPlayerTraceScope(const char* szName)
+		: m_szName(szName)
+		, m_session(CPlayerTraceRecorder::Get().IsRecording() ? CPlayerTraceRecorder::Get().RecordBegin(szName) : 0)
+	{
+	}
+
+	~CPlayerTraceScope()
+	{
+		if (m_session != 0)
+		{
+			CPlayerTraceRecorder::Get().RecordEnd(m_szName, m_session);
+		}
+	}
+
+private:
+	const char* m_szName;
+	uint32 m_session;
+};
+
+#define PLAYER_TRACE_SCOPE(name) CPlayerTraceScope playerTraceScope(name)
+#define PLAYER_TRACE_INSTANT(name)                                                               \
+	do                                                                                           \
+	{                                                                                            \
+		if (CPlayerTraceRecorder::Get().IsRecording())                                           \
+			CPlayerTraceRecorder::Get().RecordInstant(name);                                     \
+	} while (false)